@@ -0,0 +1,46 @@
+#!/usr/bin/env python3
+"""
+Analyse an archive of games with the native streaming pipeline
+
+Reads one game per line ("size p,r,c,v ...", as written by
+GameBoard.to_record()), searches every position on all cores and writes one
+JSON object per game with the engine's best move and score for each move.
+
+Usage:
+    python3 analyse_archive.py games.txt analysis.jsonl --depth 5 --workers 8
+"""
+
+import argparse
+from sequencium import CPP_AVAILABLE
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Analyse a game archive")
+    parser.add_argument("input", help="game archive, one game per line")
+    parser.add_argument("output", help="annotated games as JSON lines")
+    parser.add_argument("--depth", type=int, default=4)
+    parser.add_argument("--nodes", type=int, default=0, help="node limit per position (0 = none)")
+    parser.add_argument("--workers", type=int, default=0, help="search workers (0 = all cores)")
+    parser.add_argument("--queue-size", type=int, default=64,
+                        help="games buffered between pipeline stages")
+    args = parser.parse_args()
+    
+    if not CPP_AVAILABLE:
+        print("⚠ C++ engine not available!")
+        print("Run: python3 setup.py build_ext --inplace")
+        return
+    
+    import search_engine
+    
+    report = search_engine.analyse_archive(args.input, args.output, depth=args.depth,
+                                           nodes=args.nodes, workers=args.workers,
+                                           queue_size=args.queue_size)
+    print(f"Analysed {report['games']} games ({report['positions']} positions) in "
+          f"{report['seconds']:.1f}s with {report['workers']} workers: "
+          f"{report['positions_per_second']:.0f} positions/s")
+    if report["illegal_games"]:
+        print(f"⚠ {report['illegal_games']} games contain an illegal move")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,8 +1,20 @@
 #!/usr/bin/env python3
 """
 Performance comparison between Python and C++ implementations
+
+Usage:
+    python3 benchmark.py                  # Python vs C++ comparison
+    python3 benchmark.py latency [options] # end-to-end latency over full games
+    python3 benchmark.py replay LOG        # replay a recorded request log
+    python3 benchmark.py scaling [options] # speedup from 1 to N search threads
+    python3 benchmark.py drivers [options] # MTD(f) vs alpha-beta root driver
 """
 
+import argparse
+import json
+import os
+import random
+import sys
 import time
 from sequencium import GameBoard, Player, SequenciumAI, CPP_AVAILABLE
 
@@ -70,5 +82,454 @@ def run_comparison():
     
     print("\n" + "=" * 70)
 
+def percentiles(samples):
+    """Summarise a list of seconds as milliseconds (nearest-rank percentiles)"""
+    if not samples:
+        return {"count": 0}
+    ordered = sorted(samples)
+    
+    def rank(p):
+        return ordered[min(len(ordered) - 1, int(p / 100 * len(ordered)))] * 1000
+    
+    return {
+        "count": len(ordered),
+        "mean": sum(ordered) / len(ordered) * 1000,
+        "p50": rank(50),
+        "p90": rank(90),
+        "p99": rank(99),
+        "max": ordered[-1] * 1000,
+    }
+
+
+def game_phase(board):
+    """Classify a position by how much of the board is filled"""
+    filled = sum(len(positions) for positions in board.player_positions.values())
+    ratio = filled / (board.size * board.size)
+    if ratio < 1 / 3:
+        return "opening"
+    if ratio < 2 / 3:
+        return "middlegame"
+    return "endgame"
+
+
+def benchmark_latency(games=20, board_size=6, depth=4, random_plies=4, seed=0, use_cpp=True):
+    """
+    Play full games through SequenciumAI.get_best_move and collect latencies
+    
+    A fresh AI is constructed per game so construction cost and transposition
+    table warm-up within a game are included. The first random_plies moves of
+    each game are random so the games differ.
+    """
+    rng = random.Random(seed)
+    construction = []
+    latency = {"opening": [], "middlegame": [], "endgame": []}
+    convert = []
+    search = []
+    moves = 0
+    
+    start = time.perf_counter()
+    for _ in range(games):
+        t0 = time.perf_counter()
+        ai = SequenciumAI(max_depth=depth, use_cpp=use_cpp)
+        construction.append(time.perf_counter() - t0)
+        
+        board = GameBoard(board_size)
+        player = Player.A
+        ply = 0
+        while not board.is_game_over():
+            valid_moves = board.get_valid_moves(player)
+            if valid_moves:
+                if ply < random_plies:
+                    move = rng.choice(valid_moves)
+                else:
+                    phase = game_phase(board)
+                    t0 = time.perf_counter()
+                    move = ai.get_best_move(board, player)
+                    latency[phase].append(time.perf_counter() - t0)
+                    if ai.use_cpp:
+                        convert.append(ai.last_convert_time)
+                        search.append(ai.last_search_time)
+                    moves += 1
+                row, col, value = move
+                board.make_move(row, col, player, value)
+                ply += 1
+            player = board.next_player(player)
+    elapsed = time.perf_counter() - start
+    
+    all_latency = [t for samples in latency.values() for t in samples]
+    return {
+        "config": {
+            "games": games,
+            "board_size": board_size,
+            "depth": depth,
+            "random_plies": random_plies,
+            "seed": seed,
+            "cpp": use_cpp and CPP_AVAILABLE,
+        },
+        "games_per_second": games / elapsed if elapsed > 0 else 0.0,
+        "searched_moves": moves,
+        "construction_ms": percentiles(construction),
+        "latency_ms": {
+            "all": percentiles(all_latency),
+            **{phase: percentiles(samples) for phase, samples in latency.items()},
+        },
+        "convert_ms": percentiles(convert),
+        "search_ms": percentiles(search),
+        "convert_fraction": sum(convert) / (sum(convert) + sum(search)) if search else 0.0,
+    }
+
+
+def print_latency_report(report):
+    """Print a latency report in human-readable form"""
+    config = report["config"]
+    print("=" * 70)
+    print("SEQUENCIUM END-TO-END LATENCY")
+    print(f"{config['games']} games, {config['board_size']}x{config['board_size']}, "
+          f"depth {config['depth']}, {'C++' if config['cpp'] else 'Python'} engine")
+    print("=" * 70)
+    
+    def row(name, stats):
+        if stats["count"] == 0:
+            print(f"  {name:<12} (no samples)")
+            return
+        print(f"  {name:<12} n={stats['count']:<6} p50={stats['p50']:8.3f}ms "
+              f"p90={stats['p90']:8.3f}ms p99={stats['p99']:8.3f}ms max={stats['max']:8.3f}ms")
+    
+    print("get_best_move latency by phase:")
+    for phase, stats in report["latency_ms"].items():
+        row(phase, stats)
+    print("Breakdown:")
+    row("construct", report["construction_ms"])
+    row("convert", report["convert_ms"])
+    row("search", report["search_ms"])
+    print(f"  conversion share of C++ call time: {100 * report['convert_fraction']:.1f}%")
+    print(f"\n  Games per second: {report['games_per_second']:.2f}")
+    print("=" * 70)
+
+
+def print_replay_report(report, path):
+    """Print a request-log replay report in human-readable form"""
+    latency = report["latency_ms"]
+    pace = "full speed" if report["speed"] == 0 else f"{report['speed']:g}x recorded rate"
+    print("=" * 70)
+    print("SEQUENCIUM REQUEST REPLAY")
+    print(f"{path}: {report['requests']} requests, {report['workers']} workers, {pace}")
+    print("=" * 70)
+    print(f"  Throughput: {report['requests_per_second']:.1f} requests/s, "
+          f"{report['nodes_per_second']:,.0f} nodes/s")
+    if latency["count"]:
+        print(f"  Latency: mean={latency['mean']:.3f}ms p50={latency['p50']:.3f}ms "
+              f"p90={latency['p90']:.3f}ms p99={latency['p99']:.3f}ms max={latency['max']:.3f}ms")
+    print("=" * 70)
+
+
+def scaling_corpus(positions, board_size, random_plies, seed):
+    """Positions (board, player) after random openings of varying length"""
+    rng = random.Random(seed)
+    corpus = []
+    while len(corpus) < positions:
+        board = GameBoard(board_size)
+        player = Player.A
+        for _ in range(rng.randint(0, random_plies)):
+            valid_moves = board.get_valid_moves(player)
+            if valid_moves:
+                row, col, value = rng.choice(valid_moves)
+                board.make_move(row, col, player, value)
+            player = board.next_player(player)
+        if not board.is_game_over() and board.get_valid_moves(player):
+            corpus.append((board.to_engine_board(), player.value))
+    return corpus
+
+
+def thread_counts(max_threads):
+    """1, 2, 4, ... up to max_threads, always ending with max_threads"""
+    counts = []
+    t = 1
+    while t < max_threads:
+        counts.append(t)
+        t *= 2
+    counts.append(max_threads)
+    return counts
+
+
+def benchmark_scaling(positions=16, board_size=7, depth=6, max_threads=None,
+                      random_plies=12, seed=0, tt_size=1 << 20, placements=("local",),
+                      pin_threads=False):
+    """
+    Search the same corpus to a fixed depth at 1, 2, 4, ... N threads
+    
+    Every search starts from a cleared transposition table, so the time is
+    the time to reach the depth. Speedup and node overhead are relative to
+    one thread; node overhead is the extra work the helper threads add.
+    The TT hit rate and the share of stores that overwrite another
+    position's entry show how much the threads share and how much they
+    contend for table slots. Each NUMA placement of the table ("local",
+    "interleave") gets its own series, relative to its own one-thread run.
+    """
+    import search_engine
+    max_threads = max_threads or os.cpu_count() or 1
+    corpus = scaling_corpus(positions, board_size, random_plies, seed)
+    engine = search_engine.SearchEngine(tt_size)
+    
+    runs = []
+    for placement in placements:
+        engine.set_numa_policy(placement, pin_threads)
+        runs.extend(scaling_series(engine, corpus, board_size, depth, max_threads, placement))
+    
+    return {
+        "config": {
+            "positions": len(corpus),
+            "board_size": board_size,
+            "depth": depth,
+            "max_threads": max_threads,
+            "random_plies": random_plies,
+            "seed": seed,
+            "tt_size": tt_size,
+            "cpu_count": os.cpu_count(),
+            "numa_nodes": len(search_engine.numa_nodes()),
+            "pin_threads": pin_threads,
+        },
+        "runs": runs,
+    }
+
+
+def scaling_series(engine, corpus, board_size, depth, max_threads, placement):
+    """One scaling run per thread count with the engine's current placement"""
+    interleaved = engine.get_numa_policy()["interleaved"]
+    runs = []
+    for threads in thread_counts(max_threads):
+        seconds = 0.0
+        totals = {"nodes": 0, "main_nodes": 0, "tt_probes": 0, "tt_hits": 0,
+                  "tt_stores": 0, "tt_overwrites": 0}
+        for board, player in corpus:
+            engine.clear_tt()
+            t0 = time.perf_counter()
+            engine.find_best_move(board, board_size, player, depth, 0, threads)
+            seconds += time.perf_counter() - t0
+            stats = engine.get_search_stats()
+            for key in totals:
+                totals[key] += stats[key]
+        runs.append({
+            "placement": placement,
+            "interleaved": interleaved,
+            "threads": threads,
+            "seconds": seconds,
+            "nodes": totals["nodes"],
+            "main_nodes": totals["main_nodes"],
+            "nodes_per_second": totals["nodes"] / seconds if seconds > 0 else 0.0,
+            "tt_hit_rate": totals["tt_hits"] / totals["tt_probes"] if totals["tt_probes"] else 0.0,
+            "tt_overwrite_rate": (totals["tt_overwrites"] / totals["tt_stores"]
+                                  if totals["tt_stores"] else 0.0),
+        })
+    
+    base = runs[0]
+    for run in runs:
+        run["speedup"] = base["seconds"] / run["seconds"] if run["seconds"] > 0 else 0.0
+        run["efficiency"] = run["speedup"] / run["threads"]
+        run["nps_scaling"] = (run["nodes_per_second"] / base["nodes_per_second"]
+                              if base["nodes_per_second"] else 0.0)
+        run["node_overhead"] = run["nodes"] / base["nodes"] - 1.0 if base["nodes"] else 0.0
+    return runs
+
+
+def print_scaling_report(report):
+    """Print a thread-scaling report in human-readable form"""
+    config = report["config"]
+    print("=" * 70)
+    print("SEQUENCIUM THREAD SCALING")
+    print(f"{config['positions']} positions, {config['board_size']}x{config['board_size']}, "
+          f"depth {config['depth']}, {config['cpu_count']} CPUs, "
+          f"{config['numa_nodes']} NUMA nodes{', pinned' if config['pin_threads'] else ''}")
+    print("=" * 70)
+    placement = None
+    for run in report["runs"]:
+        if run["placement"] != placement:
+            placement = run["placement"]
+            applied = "" if run["interleaved"] or placement == "local" else " (not applied)"
+            print(f"TT placement: {placement}{applied}")
+            print(f"  {'threads':>7} {'seconds':>9} {'speedup':>8} {'effic.':>7} {'Mnps':>7} "
+                  f"{'nps x':>6} {'node ovh':>9} {'tt hit':>7} {'tt ovw':>7}")
+        print(f"  {run['threads']:>7} {run['seconds']:>9.3f} {run['speedup']:>8.2f} "
+              f"{run['efficiency']:>7.2f} {run['nodes_per_second'] / 1e6:>7.2f} "
+              f"{run['nps_scaling']:>6.2f} {100 * run['node_overhead']:>8.1f}% "
+              f"{100 * run['tt_hit_rate']:>6.1f}% {100 * run['tt_overwrite_rate']:>6.1f}%")
+    print("=" * 70)
+
+
+def benchmark_drivers(positions=32, board_size=7, depth=7, random_plies=12, seed=0,
+                      tt_size=1 << 20, drivers=("alphabeta", "mtdf")):
+    """
+    Search the same corpus to a fixed depth with each root driver
+    
+    Every search starts from a cleared transposition table. Nodes and time
+    are totals over the corpus, relative to the first driver; "agree" is
+    the share of positions where a driver picks the first driver's move
+    (equal-valued moves can legitimately differ).
+    """
+    import search_engine
+    corpus = scaling_corpus(positions, board_size, random_plies, seed)
+    engine = search_engine.SearchEngine(tt_size)
+    
+    runs = []
+    first_moves = None
+    for driver in drivers:
+        engine.set_root_driver(driver)
+        seconds = 0.0
+        nodes = passes = 0
+        moves = []
+        for board, player in corpus:
+            engine.clear_tt()
+            t0 = time.perf_counter()
+            row, col, value, _ = engine.find_best_move(board, board_size, player, depth)
+            seconds += time.perf_counter() - t0
+            stats = engine.get_search_stats()
+            nodes += stats["nodes"]
+            passes += stats["passes"]
+            moves.append((row, col, value))
+        first_moves = first_moves or moves
+        runs.append({
+            "driver": driver,
+            "seconds": seconds,
+            "nodes": nodes,
+            "passes_per_position": passes / len(corpus),
+            "agree": sum(a == b for a, b in zip(moves, first_moves)) / len(corpus),
+        })
+    engine.set_root_driver("alphabeta")
+    
+    base = runs[0]
+    for run in runs:
+        run["node_ratio"] = run["nodes"] / base["nodes"] if base["nodes"] else 0.0
+        run["time_ratio"] = run["seconds"] / base["seconds"] if base["seconds"] > 0 else 0.0
+    
+    return {
+        "config": {
+            "positions": len(corpus),
+            "board_size": board_size,
+            "depth": depth,
+            "random_plies": random_plies,
+            "seed": seed,
+            "tt_size": tt_size,
+        },
+        "runs": runs,
+    }
+
+
+def print_drivers_report(report):
+    """Print a root driver comparison in human-readable form"""
+    config = report["config"]
+    print("=" * 70)
+    print("SEQUENCIUM ROOT DRIVERS")
+    print(f"{config['positions']} positions, {config['board_size']}x{config['board_size']}, "
+          f"depth {config['depth']}")
+    print("=" * 70)
+    print(f"  {'driver':>10} {'seconds':>9} {'time x':>7} {'nodes':>11} {'nodes x':>8} "
+          f"{'passes':>7} {'agree':>6}")
+    for run in report["runs"]:
+        print(f"  {run['driver']:>10} {run['seconds']:>9.3f} {run['time_ratio']:>7.2f} "
+              f"{run['nodes']:>11} {run['node_ratio']:>8.2f} "
+              f"{run['passes_per_position']:>7.1f} {100 * run['agree']:>5.0f}%")
+    print("=" * 70)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Sequencium benchmarks")
+    sub = parser.add_subparsers(dest="mode")
+    latency = sub.add_parser("latency", help="end-to-end latency over full games")
+    latency.add_argument("--games", type=int, default=20)
+    latency.add_argument("--size", type=int, default=6)
+    latency.add_argument("--depth", type=int, default=4)
+    latency.add_argument("--random-plies", type=int, default=4)
+    latency.add_argument("--seed", type=int, default=0)
+    latency.add_argument("--python", action="store_true", help="use the Python engine")
+    latency.add_argument("--json", metavar="PATH",
+                         help="write the report as JSON ('-' for stdout)")
+    replay = sub.add_parser("replay", help="replay a recorded request log (C++ engine)")
+    replay.add_argument("log", help="log written by SearchEngine.start_recording")
+    replay.add_argument("--speed", type=float, default=0.0,
+                        help="0 for full speed, else a multiple of the recorded arrival rate")
+    replay.add_argument("--workers", type=int, default=1)
+    replay.add_argument("--json", metavar="PATH",
+                        help="write the report as JSON ('-' for stdout)")
+    scaling = sub.add_parser("scaling", help="time-to-depth at 1, 2, 4, ... N threads (C++ engine)")
+    scaling.add_argument("--positions", type=int, default=16)
+    scaling.add_argument("--size", type=int, default=7)
+    scaling.add_argument("--depth", type=int, default=6)
+    scaling.add_argument("--max-threads", type=int, default=None,
+                         help="largest thread count (default: all CPUs)")
+    scaling.add_argument("--random-plies", type=int, default=12)
+    scaling.add_argument("--seed", type=int, default=0)
+    scaling.add_argument("--tt-size", type=int, default=1 << 20)
+    scaling.add_argument("--numa", nargs="+", choices=["local", "interleave"], default=["local"],
+                         help="transposition table placements to compare")
+    scaling.add_argument("--pin-threads", action="store_true",
+                         help="pin search threads to NUMA nodes round-robin")
+    scaling.add_argument("--json", metavar="PATH",
+                         help="write the report as JSON ('-' for stdout)")
+    drivers = sub.add_parser("drivers", help="MTD(f) vs alpha-beta root driver (C++ engine)")
+    drivers.add_argument("--positions", type=int, default=32)
+    drivers.add_argument("--size", type=int, default=7)
+    drivers.add_argument("--depth", type=int, default=7)
+    drivers.add_argument("--random-plies", type=int, default=12)
+    drivers.add_argument("--seed", type=int, default=0)
+    drivers.add_argument("--tt-size", type=int, default=1 << 20)
+    drivers.add_argument("--json", metavar="PATH",
+                         help="write the report as JSON ('-' for stdout)")
+    args = parser.parse_args()
+    
+    if args.mode == "drivers":
+        report = benchmark_drivers(args.positions, args.size, args.depth, args.random_plies,
+                                   args.seed, args.tt_size)
+        if args.json == "-":
+            json.dump(report, sys.stdout, indent=2)
+            print()
+        else:
+            print_drivers_report(report)
+            if args.json:
+                with open(args.json, "w") as f:
+                    json.dump(report, f, indent=2)
+        return
+    
+    if args.mode == "scaling":
+        report = benchmark_scaling(args.positions, args.size, args.depth, args.max_threads,
+                                   args.random_plies, args.seed, args.tt_size, args.numa,
+                                   args.pin_threads)
+        if args.json == "-":
+            json.dump(report, sys.stdout, indent=2)
+            print()
+        else:
+            print_scaling_report(report)
+            if args.json:
+                with open(args.json, "w") as f:
+                    json.dump(report, f, indent=2)
+        return
+    
+    if args.mode == "replay":
+        import search_engine
+        report = search_engine.replay_requests(args.log, args.speed, args.workers)
+        if args.json == "-":
+            json.dump(report, sys.stdout, indent=2)
+            print()
+        else:
+            print_replay_report(report, args.log)
+            if args.json:
+                with open(args.json, "w") as f:
+                    json.dump(report, f, indent=2)
+        return
+    
+    if args.mode == "latency":
+        report = benchmark_latency(args.games, args.size, args.depth, args.random_plies,
+                                   args.seed, use_cpp=not args.python)
+        if args.json == "-":
+            json.dump(report, sys.stdout, indent=2)
+            print()
+        else:
+            print_latency_report(report)
+            if args.json:
+                with open(args.json, "w") as f:
+                    json.dump(report, f, indent=2)
+    else:
+        run_comparison()
+
+
 if __name__ == "__main__":
-    run_comparison()
+    main()
@@ -5,21 +5,114 @@
 
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 #include <vector>
 #include <array>
 #include <algorithm>
 #include <limits>
+#include <cmath>
 #include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <random>
 #include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sched.h>
+#include <unistd.h>
 
 namespace py = pybind11;
 
 // Constants
 constexpr int MAX_BOARD_SIZE = 10;
+constexpr int MAX_SPARSE_BOARD_SIZE = 64;  // SparseEngine; TT moves keep 6 bits per coordinate
+constexpr int MAX_CELLS = MAX_BOARD_SIZE * MAX_BOARD_SIZE;
+constexpr int MAX_PLAYERS = 4;
+constexpr int MAX_SEARCH_THREADS = 256;
 constexpr int PLAYER_A = 1;
 constexpr int PLAYER_B = 2;
 constexpr int EMPTY = 0;
 
+// Bitboard: one bit per cell, square index = row * MAX_BOARD_SIZE + col
+// (the same row-major layout as BoardState::board)
+using Bitboard = unsigned __int128;
+
+inline Bitboard square_bit(int sq) {
+    return static_cast<Bitboard>(1) << sq;
+}
+
+inline int popcount(Bitboard b) {
+    return __builtin_popcountll(static_cast<uint64_t>(b)) +
+           __builtin_popcountll(static_cast<uint64_t>(b >> 64));
+}
+
+// Index of the lowest set bit, which is then cleared
+inline int pop_lsb(Bitboard& b) {
+    uint64_t lo = static_cast<uint64_t>(b);
+    int sq = lo ? __builtin_ctzll(lo)
+                : 64 + __builtin_ctzll(static_cast<uint64_t>(b >> 64));
+    b &= b - 1;
+    return sq;
+}
+
+// Per-board-size masks used for neighbour shifts
+struct BoardMasks {
+    Bitboard full;            // all on-board squares
+    Bitboard not_first_col;   // squares that may shift one column left
+    Bitboard not_last_col;    // squares that may shift one column right
+    Bitboard neighbors[MAX_CELLS];
+};
+
+// All 8-directional neighbours of the squares in b (may include b itself)
+inline Bitboard dilate(Bitboard b, const BoardMasks& masks) {
+    Bitboard h = b | ((b & masks.not_first_col) >> 1) | ((b & masks.not_last_col) << 1);
+    return (h | (h << MAX_BOARD_SIZE) | (h >> MAX_BOARD_SIZE)) & masks.full;
+}
+
+inline const BoardMasks& board_masks(int size) {
+    static const auto tables = [] {
+        std::vector<BoardMasks> t(MAX_BOARD_SIZE + 1);
+        for (int sz = 0; sz <= MAX_BOARD_SIZE; ++sz) {
+            BoardMasks& m = t[sz];
+            m.full = m.not_first_col = m.not_last_col = 0;
+            for (int r = 0; r < sz; ++r) {
+                for (int c = 0; c < sz; ++c) {
+                    Bitboard bit = square_bit(r * MAX_BOARD_SIZE + c);
+                    m.full |= bit;
+                    if (c > 0) m.not_first_col |= bit;
+                    if (c < sz - 1) m.not_last_col |= bit;
+                }
+            }
+            for (int sq = 0; sq < MAX_CELLS; ++sq) {
+                m.neighbors[sq] = (m.full & square_bit(sq))
+                    ? dilate(square_bit(sq), m) & ~square_bit(sq) : 0;
+            }
+        }
+        return t;
+    }();
+    return tables[size];
+}
+
+inline int next_player(int player, int num_players) {
+    return player % num_players + 1;
+}
+
 // Move structure
 struct Move {
     int row;
@@ -35,17 +128,32 @@ struct Move {
 // Board state representation
 struct BoardState {
     int size;
+    int num_players;
     int board[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
-    int player_max_values[3];  // index 0 unused, 1 for A, 2 for B
+    int player_max_values[MAX_PLAYERS + 1];  // index 0 unused, 1 for A, 2 for B, ...
+    Bitboard occupancy[MAX_PLAYERS + 1];     // index 0 is the union of all players
+    
+    BoardState() : BoardState(0) {}
     
-    BoardState() : size(0) {
+    BoardState(int sz, int players = 2) : size(sz), num_players(players) {
         std::memset(board, 0, sizeof(board));
         std::memset(player_max_values, 0, sizeof(player_max_values));
+        std::memset(occupancy, 0, sizeof(occupancy));
     }
     
-    BoardState(int sz) : size(sz) {
-        std::memset(board, 0, sizeof(board));
-        std::memset(player_max_values, 0, sizeof(player_max_values));
+    // Cell value of a square index (board is row-major with the bitboard stride)
+    int value_at(int sq) const {
+        return (&board[0][0])[sq] % 100;
+    }
+    
+    void set_cell(int row, int col, int player, int value) {
+        board[row][col] = player * 100 + value;
+        Bitboard bit = square_bit(row * MAX_BOARD_SIZE + col);
+        occupancy[player] |= bit;
+        occupancy[0] |= bit;
+        if (value > player_max_values[player]) {
+            player_max_values[player] = value;
+        }
     }
     
     // Hash for transposition table
@@ -61,409 +169,5630 @@ struct BoardState {
     
     void copy_from(const BoardState& other) {
         size = other.size;
+        num_players = other.num_players;
         std::memcpy(board, other.board, sizeof(board));
         std::memcpy(player_max_values, other.player_max_values, sizeof(player_max_values));
+        std::memcpy(occupancy, other.occupancy, sizeof(occupancy));
+    }
+};
+
+inline uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// CPUs of each NUMA node, from sysfs; a single node with no CPU list where
+// that is not available
+inline std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size();
+        std::string range = list.substr(pos, end - pos);
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        } catch (const std::exception&) {
+            break;
+        }
+        pos = end + 1;
     }
+    return cpus;
+}
+
+// Online NUMA node IDs (which need not be contiguous, e.g. "0,2") and the
+// CPUs of each
+struct NumaTopology {
+    std::vector<int> ids;
+    std::vector<std::vector<int>> cpus;
 };
 
-// Transposition table entry
+inline const NumaTopology& numa_topology() {
+    static const auto topology = [] {
+        NumaTopology result;
+        std::ifstream online("/sys/devices/system/node/online");
+        std::string list;
+        if (online && std::getline(online, list)) {
+            for (int node : parse_cpu_list(list)) {
+                std::ifstream cpus("/sys/devices/system/node/node" + std::to_string(node) +
+                                   "/cpulist");
+                std::string cpu_list;
+                std::getline(cpus, cpu_list);
+                result.ids.push_back(node);
+                result.cpus.push_back(parse_cpu_list(cpu_list));
+            }
+        }
+        if (result.ids.empty()) {
+            result.ids.push_back(0);
+            result.cpus.emplace_back();
+        }
+        return result;
+    }();
+    return topology;
+}
+
+inline const std::vector<std::vector<int>>& numa_node_cpus() {
+    return numa_topology().cpus;
+}
+
+// Bitmask of the given node IDs in the layout mbind expects
+inline std::vector<unsigned long> numa_node_mask(const std::vector<int>& ids) {
+    int highest = ids.empty() ? 0 : *std::max_element(ids.begin(), ids.end());
+    std::vector<unsigned long> mask(highest / 64 + 1, 0);
+    for (int node : ids) {
+        mask[node / 64] |= 1UL << (node % 64);
+    }
+    return mask;
+}
+
+// Spread the pages of a mapping round-robin over all online NUMA nodes
+// (mbind(MPOL_INTERLEAVE), called directly so libnuma is not needed).
+// False if the kernel refuses or there is only one node.
+inline bool interleave_pages(void* addr, size_t bytes) {
+#ifdef SYS_mbind
+    constexpr int MPOL_INTERLEAVE_MODE = 3;
+    const std::vector<int>& ids = numa_topology().ids;
+    if (ids.size() < 2) {
+        return false;
+    }
+    std::vector<unsigned long> mask = numa_node_mask(ids);
+    return syscall(SYS_mbind, addr, bytes, MPOL_INTERLEAVE_MODE, mask.data(),
+                   mask.size() * 64 + 1, 0) == 0;
+#else
+    (void)addr;
+    (void)bytes;
+    return false;
+#endif
+}
+
+// Pin the calling thread to the CPUs of a NUMA node; false if unknown
+inline bool pin_to_node(size_t node) {
+    const auto& nodes = numa_node_cpus();
+    const auto& cpus = nodes[node % nodes.size()];
+    if (cpus.empty()) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+// Transposition table entry. Both words are written with relaxed atomics
+// and the key is stored xor-ed with the data, so an entry torn by two
+// threads writing at once simply fails the key check (lockless hashing).
 struct TTEntry {
-    uint64_t hash;
-    int depth;
-    int score;
-    int flag;  // 0: exact, 1: lower bound, 2: upper bound
-    Move best_move;
+    std::atomic<uint64_t> key_xor_data;
+    std::atomic<uint64_t> data;
+    
+    // data layout: score (32) | depth (8) | flag (2) | row (6) | col (6) | value (10).
+    // Dense boards never exceed value 99; sparse boards recover larger values
+    // from the square (see SparseEngine::minimax).
+    static constexpr int MOVE_VALUE_MASK = 1023;
+    
+    static uint64_t pack(int depth, int score, int flag, const Move& move) {
+        return static_cast<uint32_t>(score) |
+               (static_cast<uint64_t>(std::min(std::max(depth, 0), 255)) << 32) |
+               (static_cast<uint64_t>(flag & 3) << 40) |
+               (static_cast<uint64_t>(move.row & 63) << 42) |
+               (static_cast<uint64_t>(move.col & 63) << 48) |
+               (static_cast<uint64_t>(move.value & MOVE_VALUE_MASK) << 54);
+    }
+    static int score_of(uint64_t d) { return static_cast<int32_t>(static_cast<uint32_t>(d)); }
+    static int depth_of(uint64_t d) { return static_cast<int>((d >> 32) & 255); }
+    static int flag_of(uint64_t d) { return static_cast<int>((d >> 40) & 3); }
+    static Move move_of(uint64_t d) {
+        return Move(static_cast<int>((d >> 42) & 63), static_cast<int>((d >> 48) & 63),
+                    static_cast<int>(d >> 54));
+    }
     
-    TTEntry() : hash(0), depth(0), score(0), flag(0) {}
+    // Usable only if exact or the stored bound falls outside (alpha, beta)
+    static bool bound_cutoff(uint64_t d, int alpha, int beta, int& score) {
+        int flag = flag_of(d);
+        int stored = score_of(d);
+        if (flag == 0 ||
+            (flag == 1 && stored >= beta) ||
+            (flag == 2 && stored <= alpha)) {
+            score = stored;
+            return true;
+        }
+        return false;
+    }
 };
 
-// Transposition table
+// Transposition table, safe to share between search threads. Entries live
+// in an anonymous mapping: its pages land on the NUMA node of the thread
+// that first touches them or, with interleave set, are spread over all
+// nodes, so no node serves every probe. A shrink compacts the entries into
+// the front of the mapping and returns the tail, never holding two tables.
 class TranspositionTable {
 private:
+    struct Release {
+        size_t mapped_bytes = 0;
+        void operator()(TTEntry* entries) const {
+            munmap(entries, mapped_bytes);
+        }
+    };
+    using Entries = std::unique_ptr<TTEntry[], Release>;
+    
     size_t table_size;
-    std::vector<TTEntry> table;
+    bool interleave = false;
+    bool interleaved = false;  // the last allocation was actually interleaved
+    Entries table;
+    
+    Entries allocate(size_t entries) {
+        size_t bytes = std::max<size_t>(entries, 1) * sizeof(TTEntry);
+        void* mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        interleaved = interleave && interleave_pages(mem, bytes);
+        // Zeroed pages are empty entries; constructing them touches each
+        // page, placing it (under the interleave policy if set)
+        TTEntry* first = static_cast<TTEntry*>(mem);
+        for (size_t i = 0; i < entries; ++i) {
+            new (&first[i]) TTEntry();
+        }
+        return Entries(first, Release{bytes});
+    }
+    
+    // Keep the deeper of an entry and the slot's current one
+    static void place(TTEntry& slot, uint64_t hash, uint64_t d) {
+        uint64_t slot_data = slot.data.load(std::memory_order_relaxed);
+        if (slot_data == 0 || TTEntry::depth_of(d) >= TTEntry::depth_of(slot_data)) {
+            slot.key_xor_data.store(hash ^ d, std::memory_order_relaxed);
+            slot.data.store(d, std::memory_order_relaxed);
+        }
+    }
     
 public:
-    TranspositionTable(size_t size = 1048576) : table_size(size), table(size) {}
+    TranspositionTable(size_t size = 1048576) : table_size(size), table(allocate(size)) {}
     
     void resize(size_t new_size) {
+        table.reset();
         table_size = new_size;
-        table.clear();
-        table.resize(new_size);
+        table = allocate(new_size);
+    }
+    
+    // Reallocate (emptied) with or without interleaved placement
+    void set_interleave(bool enable) {
+        interleave = enable;
+        resize(table_size);
+    }
+    
+    bool is_interleaved() const {
+        return interleaved;
     }
     
-    void store(uint64_t hash, int depth, int score, int flag, const Move& move) {
-        size_t index = hash % table_size;
-        TTEntry& entry = table[index];
+    // Move all entries into a table of a different size, keeping the deeper
+    // entry when two land on the same slot. Shrinking works in place: each
+    // entry is taken out of its slot and put into hash % new_size (a slot
+    // not yet visited may take it, and it stays when that slot's turn
+    // comes), then the tail of the mapping is released.
+    void rehash(size_t new_size) {
+        if (new_size >= table_size) {
+            Entries new_table = allocate(new_size);
+            for (size_t i = 0; i < table_size; ++i) {
+                uint64_t d = table[i].data.load(std::memory_order_relaxed);
+                uint64_t hash = table[i].key_xor_data.load(std::memory_order_relaxed) ^ d;
+                if (d == 0 && hash == 0) continue;
+                place(new_table[hash % new_size], hash, d);
+            }
+            table.swap(new_table);
+            table_size = new_size;
+            return;
+        }
         
-        // Replace if deeper or empty
-        if (entry.hash == 0 || depth >= entry.depth) {
-            entry.hash = hash;
-            entry.depth = depth;
-            entry.score = score;
-            entry.flag = flag;
-            entry.best_move = move;
+        new_size = std::max<size_t>(new_size, 1);
+        for (size_t i = 0; i < table_size; ++i) {
+            uint64_t d = table[i].data.load(std::memory_order_relaxed);
+            uint64_t hash = table[i].key_xor_data.load(std::memory_order_relaxed) ^ d;
+            if (d == 0 && hash == 0) continue;
+            size_t target = hash % new_size;
+            if (target == i) continue;
+            if (i < new_size) {
+                table[i].key_xor_data.store(0, std::memory_order_relaxed);
+                table[i].data.store(0, std::memory_order_relaxed);
+            }
+            place(table[target], hash, d);
+        }
+        size_t bytes = new_size * sizeof(TTEntry);
+        if (mremap(table.get(), table.get_deleter().mapped_bytes, bytes, 0) != MAP_FAILED) {
+            table.get_deleter().mapped_bytes = bytes;
         }
+        table_size = new_size;
+    }
+    
+    size_t size() const {
+        return table_size;
+    }
+    
+    size_t memory_bytes() const {
+        return table_size * sizeof(TTEntry);
     }
     
-    bool probe(uint64_t hash, int depth, int& score, Move& move) {
-        size_t index = hash % table_size;
-        const TTEntry& entry = table[index];
+    // Returns true if the store replaced another position's entry
+    bool store(uint64_t hash, int depth, int score, int flag, const Move& move) {
+        TTEntry& entry = table[hash % table_size];
+        uint64_t old_data = entry.data.load(std::memory_order_relaxed);
         
-        if (entry.hash == hash && entry.depth >= depth) {
-            score = entry.score;
-            move = entry.best_move;
-            return true;
+        // Replace if deeper or empty
+        if (old_data == 0 || depth >= TTEntry::depth_of(old_data)) {
+            uint64_t old_key = entry.key_xor_data.load(std::memory_order_relaxed) ^ old_data;
+            uint64_t d = TTEntry::pack(depth, score, flag, move);
+            entry.key_xor_data.store(hash ^ d, std::memory_order_relaxed);
+            entry.data.store(d, std::memory_order_relaxed);
+            return old_data != 0 && old_key != hash;
         }
         return false;
     }
     
+    // Probe honouring the stored bound: usable only if the entry is exact or
+    // its bound already falls outside the (alpha, beta) window. The stored
+    // move is returned for ordering whenever the key matches.
+    bool probe(uint64_t hash, int depth, int alpha, int beta, int& score, Move& move) const {
+        const TTEntry& entry = table[hash % table_size];
+        uint64_t d = entry.data.load(std::memory_order_relaxed);
+        
+        if ((entry.key_xor_data.load(std::memory_order_relaxed) ^ d) != hash || d == 0) {
+            return false;
+        }
+        move = TTEntry::move_of(d);
+        if (TTEntry::depth_of(d) < depth) {
+            return false;
+        }
+        return TTEntry::bound_cutoff(d, alpha, beta, score);
+    }
+    
     void clear() {
-        table.clear();
-        table.resize(table_size);
+        resize(table_size);
     }
 };
 
-// Search engine class
-class SearchEngine {
-private:
-    TranspositionTable tt;
-    int nodes_evaluated;
+// Exact encoding of a position of up to 6x6 with the side to move and the
+// root player, for solving where a hash collision would corrupt a proof.
+// Fields are packed back to back: size (4 bits), players (3), to_move (3),
+// root (3), then each player's occupancy (size^2 bits each) and the value of
+// every occupied cell in square order (6 bits each) - at most 373 bits.
+struct ExactKey {
+    static constexpr int MAX_SIZE = 6;
     
-    // Get cell value: returns player*100 + value, or 0 for empty
-    int get_cell(const BoardState& board, int row, int col) const {
-        if (row < 0 || row >= board.size || col < 0 || col >= board.size) {
-            return -1;
+    std::array<uint64_t, 6> words{};
+    
+    bool operator==(const ExactKey& other) const {
+        return words == other.words;
+    }
+    
+    // False if the board is too large (or holds values too high) to encode
+    static bool make(const BoardState& board, int to_move, int root, ExactKey& key) {
+        if (board.size > MAX_SIZE) {
+            return false;
         }
-        return board.board[row][col];
+        key.words.fill(0);
+        int bit = 0;
+        auto put = [&](uint64_t field, int width) {
+            key.words[bit >> 6] |= field << (bit & 63);
+            if ((bit & 63) + width > 64) {
+                key.words[(bit >> 6) + 1] |= field >> (64 - (bit & 63));
+            }
+            bit += width;
+        };
+        put(board.size, 4);
+        put(board.num_players, 3);
+        put(to_move, 3);
+        put(root, 3);
+        uint64_t row_mask = (1ULL << board.size) - 1;
+        for (int p = 1; p <= board.num_players; ++p) {
+            for (int r = 0; r < board.size; ++r) {
+                put(static_cast<uint64_t>(board.occupancy[p] >> (r * MAX_BOARD_SIZE)) & row_mask,
+                    board.size);
+            }
+        }
+        Bitboard occupied = board.occupancy[0];
+        while (occupied) {
+            int value = board.value_at(pop_lsb(occupied));
+            if (value > 63) {
+                return false;
+            }
+            put(value, 6);
+        }
+        return true;
     }
+};
+
+// Transposition table keyed by exact positions: one cache line per entry,
+// indexed by the search hash but only hit when the full key matches.
+// Readers and writers take a per-entry spin flag with try-lock semantics,
+// so a contended probe misses and a contended store is dropped.
+class VerifiedTable {
+public:
+    struct alignas(64) Entry {
+        std::atomic<uint32_t> busy{0};
+        uint64_t data = 0;
+        ExactKey key;
+    };
+    static_assert(sizeof(Entry) == 64, "verified entries should fill one cache line");
     
-    // Extract player from cell value
-    int get_player(int cell_value) const {
-        if (cell_value == 0) return 0;
-        return cell_value / 100;
+private:
+    size_t table_size;
+    std::unique_ptr<Entry[]> table;
+    
+    bool lock(Entry& entry) const {
+        return entry.busy.load(std::memory_order_relaxed) == 0 &&
+               entry.busy.exchange(1, std::memory_order_acquire) == 0;
     }
     
-    // Extract value from cell value
-    int get_value(int cell_value) const {
-        if (cell_value == 0) return 0;
-        return cell_value % 100;
+public:
+    explicit VerifiedTable(size_t size) : table_size(size), table(new Entry[size]) {}
+    
+    size_t size() const {
+        return table_size;
     }
     
-    // Generate valid moves for a player
-    std::vector<Move> generate_moves(const BoardState& board, int player) const {
-        std::vector<Move> moves;
-        bool visited[MAX_BOARD_SIZE][MAX_BOARD_SIZE] = {};
-        
-        // Find all cells owned by player and their neighbors
-        for (int i = 0; i < board.size; ++i) {
-            for (int j = 0; j < board.size; ++j) {
-                int cell = board.board[i][j];
-                if (cell > 0 && get_player(cell) == player) {
-                    int current_value = get_value(cell);
-                    int new_value = current_value + 1;
-                    
-                    // Check all 8 neighbors
-                    for (int dr = -1; dr <= 1; ++dr) {
-                        for (int dc = -1; dc <= 1; ++dc) {
-                            if (dr == 0 && dc == 0) continue;
-                            
-                            int nr = i + dr;
-                            int nc = j + dc;
-                            
-                            if (nr >= 0 && nr < board.size && 
-                                nc >= 0 && nc < board.size && 
-                                board.board[nr][nc] == 0 && !visited[nr][nc]) {
-                                
-                                visited[nr][nc] = true;
-                                moves.emplace_back(nr, nc, new_value);
-                            }
-                        }
-                    }
-                }
-            }
+    // Returns true if the store replaced another position's entry
+    bool store(uint64_t hash, const ExactKey& key, int depth, int score, int flag,
+               const Move& move) {
+        Entry& entry = table[mix64(hash) % table_size];
+        if (!lock(entry)) {
+            return false;
         }
-        
-        // Keep only moves with maximum value for each position
-        std::sort(moves.begin(), moves.end(), 
-                 [](const Move& a, const Move& b) {
-                     if (a.row != b.row) return a.row < b.row;
-                     if (a.col != b.col) return a.col < b.col;
-                     return a.value > b.value;
-                 });
-        
-        std::vector<Move> result;
-        for (size_t i = 0; i < moves.size(); ++i) {
-            if (i == 0 || moves[i].row != moves[i-1].row || moves[i].col != moves[i-1].col) {
-                result.push_back(moves[i]);
-            }
+        bool replaced = false;
+        if (entry.data == 0 || depth >= TTEntry::depth_of(entry.data)) {
+            replaced = entry.data != 0 && !(entry.key == key);
+            entry.key = key;
+            entry.data = TTEntry::pack(depth, score, flag, move);
         }
-        
-        return result;
+        entry.busy.store(0, std::memory_order_release);
+        return replaced;
     }
     
-    // Make a move on the board
-    void make_move(BoardState& board, const Move& move, int player) const {
-        int cell_value = player * 100 + move.value;
-        board.board[move.row][move.col] = cell_value;
-        
-        // Update max value
-        if (move.value > board.player_max_values[player]) {
-            board.player_max_values[player] = move.value;
+    // Same bound rules as TranspositionTable::probe
+    bool probe(uint64_t hash, const ExactKey& key, int depth, int alpha, int beta, int& score,
+               Move& move) const {
+        Entry& entry = table[mix64(hash) % table_size];
+        if (!lock(entry)) {
+            return false;
+        }
+        uint64_t d = entry.key == key ? entry.data : 0;
+        entry.busy.store(0, std::memory_order_release);
+        if (d == 0) {
+            return false;
+        }
+        move = TTEntry::move_of(d);
+        if (TTEntry::depth_of(d) < depth) {
+            return false;
         }
+        return TTEntry::bound_cutoff(d, alpha, beta, score);
     }
     
-    // Unmake a move
-    void unmake_move(BoardState& board, const Move& move, int player) const {
-        board.board[move.row][move.col] = 0;
-        
-        // Recompute max value for player (slower but correct)
-        board.player_max_values[player] = 0;
-        for (int i = 0; i < board.size; ++i) {
-            for (int j = 0; j < board.size; ++j) {
-                int cell = board.board[i][j];
-                if (cell > 0 && get_player(cell) == player) {
-                    int val = get_value(cell);
-                    if (val > board.player_max_values[player]) {
-                        board.player_max_values[player] = val;
-                    }
-                }
+    void clear() {
+        table.reset(new Entry[table_size]);
+    }
+};
+
+// Memory limit and usage of the enclosing cgroup, in bytes
+struct CgroupMemory {
+    uint64_t limit;
+    uint64_t usage;
+};
+
+inline bool read_uint64_file(const std::string& path, uint64_t& value) {
+    std::ifstream in(path);
+    std::string text;
+    if (!(in >> text) || text == "max") {
+        return false;
+    }
+    try {
+        value = std::stoull(text);
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+// Read cgroup v2 memory.max/memory.current for this process, falling back
+// to the cgroup v1 memory controller. Returns false if there is no limit.
+inline bool read_cgroup_memory(CgroupMemory& mem) {
+    std::ifstream cgroup("/proc/self/cgroup");
+    std::string line;
+    while (std::getline(cgroup, line)) {
+        if (line.rfind("0::", 0) == 0) {
+            std::string dir = "/sys/fs/cgroup" + line.substr(3);
+            if (read_uint64_file(dir + "/memory.max", mem.limit) &&
+                read_uint64_file(dir + "/memory.current", mem.usage)) {
+                return true;
             }
         }
     }
+    // cgroup v1 reports an effectively unlimited limit as a huge value
+    return read_uint64_file("/sys/fs/cgroup/memory/memory.limit_in_bytes", mem.limit) &&
+           read_uint64_file("/sys/fs/cgroup/memory/memory.usage_in_bytes", mem.usage) &&
+           mem.limit < (1ULL << 50);
+}
+
+// Key of a position together with the player to move (never 0)
+inline uint64_t position_key(const BoardState& board, int to_move) {
+    uint64_t key = mix64(board.hash() ^ (static_cast<uint64_t>(to_move) << 56));
+    return key ? key : 1;
+}
+
+inline uint32_t pack_move(const Move& move) {
+    return (static_cast<uint32_t>(move.row) << 24) | (static_cast<uint32_t>(move.col) << 16) |
+           static_cast<uint32_t>(move.value);
+}
+
+inline Move unpack_move(uint32_t packed) {
+    return Move(packed >> 24, (packed >> 16) & 0xFF, packed & 0xFFFF);
+}
+
+// Experience book: a memory-mapped open-addressing hash table of positions
+// seen in finished games. Games are appended to "<path>.log" and merged
+// into the table; any number of processes may append, one should merge.
+// The moves tried from each position are kept in the same table as edge
+// entries, so a best move whose results turn bad can be replaced by the
+// best of its siblings.
+class ExperienceBook {
+public:
+    // Score of a position is the game outcome (+1 win, 0 tie, -1 loss) for
+    // the player who moved into it, summed over visits. best_move is the
+    // move from this position whose child has the best average for the mover.
+    struct Entry {
+        uint64_t key;
+        uint64_t best_child;
+        int64_t score_sum;
+        uint32_t visits;
+        uint32_t best_move;
+    };
     
-    // Fast mobility count (count potential moves without generating full move list)
-    int count_mobility(const BoardState& board, int player) const {
-        bool visited[MAX_BOARD_SIZE][MAX_BOARD_SIZE] = {};
-        int count = 0;
-        
-        for (int i = 0; i < board.size; ++i) {
-            for (int j = 0; j < board.size; ++j) {
-                int cell = board.board[i][j];
-                if (cell > 0 && get_player(cell) == player) {
-                    // Check all 8 neighbors
-                    for (int dr = -1; dr <= 1; ++dr) {
-                        for (int dc = -1; dc <= 1; ++dc) {
-                            if (dr == 0 && dc == 0) continue;
-                            
-                            int nr = i + dr;
-                            int nc = j + dc;
-                            
-                            if (nr >= 0 && nr < board.size && 
-                                nc >= 0 && nc < board.size && 
-                                board.board[nr][nc] == 0 && !visited[nr][nc]) {
-                                
-                                visited[nr][nc] = true;
-                                count++;
-                            }
-                        }
-                    }
+    // One move of a finished game, as written to the append log
+    struct LogRecord {
+        uint64_t parent_key;
+        uint64_t child_key;
+        uint32_t move;
+        int32_t outcome;  // for the player making the move
+    };
+    
+private:
+    struct Header {
+        char magic[8];
+        uint64_t capacity;
+        uint64_t count;
+        uint64_t reserved;
+    };
+    
+    static constexpr char MAGIC[8] = {'S', 'Q', 'X', 'B', 'O', 'O', 'K', '1'};
+    
+    std::string path;
+    int fd = -1;
+    size_t mapped_bytes = 0;
+    Header* header = nullptr;
+    Entry* entries = nullptr;
+    
+    Entry* find(uint64_t key, bool insert) {
+        uint64_t mask = header->capacity - 1;
+        for (uint64_t i = key & mask;; i = (i + 1) & mask) {
+            Entry& entry = entries[i];
+            if (entry.key == key) {
+                return &entry;
+            }
+            if (entry.key == 0) {
+                // Keep a tenth of the table free so probe chains stay short
+                if (!insert || header->count * 10 >= header->capacity * 9) {
+                    return nullptr;
                 }
+                entry.key = key;
+                header->count++;
+                return &entry;
             }
         }
-        return count;
     }
     
-    // Evaluate position
-    int evaluate(const BoardState& board, int player) const {
-        int opponent = (player == PLAYER_A) ? PLAYER_B : PLAYER_A;
-        
-        // Primary: max value difference
-        int max_diff = board.player_max_values[player] - board.player_max_values[opponent];
-        
-        // Secondary: count cells
-        int player_cells = 0, opponent_cells = 0;
-        for (int i = 0; i < board.size; ++i) {
-            for (int j = 0; j < board.size; ++j) {
-                int cell = board.board[i][j];
-                if (cell > 0) {
-                    if (get_player(cell) == player) {
-                        player_cells++;
-                    } else if (get_player(cell) == opponent) {
-                        opponent_cells++;
-                    }
+    static double average(const Entry* entry) {
+        return entry && entry->visits ? static_cast<double>(entry->score_sum) / entry->visits : -2.0;
+    }
+    
+    // Edge i of a position lives under a key derived from the parent key and
+    // holds the child key in best_child and the move in best_move (visits
+    // stay 0). A position's edges end at the first missing index.
+    static uint64_t edge_key(uint64_t parent_key, uint32_t index) {
+        return mix64(parent_key ^ (0xD6E8FEB86659FD93ULL * (index + 1))) | 1;
+    }
+    
+    void add_edge(uint64_t parent_key, uint64_t child_key, uint32_t move) {
+        for (uint32_t i = 0;; ++i) {
+            Entry* edge = find(edge_key(parent_key, i), false);
+            if (!edge) {
+                edge = find(edge_key(parent_key, i), true);
+                if (edge) {
+                    edge->best_child = child_key;
+                    edge->best_move = move;
                 }
+                return;
+            }
+            if (edge->best_child == child_key) {
+                return;
             }
         }
-        int cell_diff = player_cells - opponent_cells;
-        
-        // Tertiary: mobility (use fast count)
-        int mobility_diff = count_mobility(board, player) - count_mobility(board, opponent);
-        
-        return max_diff * 100 + cell_diff * 10 + mobility_diff;
     }
     
-    // Move ordering for better pruning (Stockfish-inspired)
-    void order_moves(std::vector<Move>& moves, const BoardState& board, int player) const {
-        for (auto& move : moves) {
-            // Higher value moves first
-            move.score = move.value * 1000;
-            
-            // Center control bonus
-            int center = board.size / 2;
-            int dist = std::abs(move.row - center) + std::abs(move.col - center);
-            move.score += (board.size - dist) * 10;
+    // Point the parent at its best-scoring recorded child; the incumbent
+    // keeps ties
+    void rescan(Entry* parent, uint64_t parent_key) {
+        double best = average(find(parent->best_child, false));
+        for (uint32_t i = 0;; ++i) {
+            const Entry* edge = find(edge_key(parent_key, i), false);
+            if (!edge) {
+                return;
+            }
+            double score = average(find(edge->best_child, false));
+            if (score > best) {
+                best = score;
+                parent->best_child = edge->best_child;
+                parent->best_move = edge->best_move;
+            }
         }
-        
-        std::sort(moves.begin(), moves.end(), 
-                 [](const Move& a, const Move& b) { return a.score > b.score; });
     }
     
-    // Minimax with alpha-beta pruning
-    int minimax(BoardState& board, int depth, int alpha, int beta, 
-                bool maximizing, int player, Move& best_move) {
-        nodes_evaluated++;
+public:
+    ExperienceBook() = default;
+    ExperienceBook(const ExperienceBook&) = delete;
+    ExperienceBook& operator=(const ExperienceBook&) = delete;
+    
+    ~ExperienceBook() {
+        close();
+    }
+    
+    // Map the book file, creating it with the given capacity (rounded up to
+    // a power of two) if it does not exist yet
+    void open(const std::string& book_path, uint64_t capacity) {
+        close();
+        uint64_t cap = 1024;
+        while (cap < capacity) cap <<= 1;
         
-        // Check transposition table
-        uint64_t hash = board.hash();
-        Move tt_move;
-        int tt_score;
-        if (tt.probe(hash, depth, tt_score, tt_move)) {
-            best_move = tt_move;
-            return tt_score;
+        fd = ::open(book_path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open experience book: " + book_path);
         }
-        
-        int opponent = (player == PLAYER_A) ? PLAYER_B : PLAYER_A;
-        int current_player = maximizing ? player : opponent;
-        
-        // Terminal condition
-        if (depth == 0) {
-            int score = evaluate(board, player);
-            tt.store(hash, depth, score, 0, best_move);
-            return score;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close();
+            throw std::runtime_error("cannot stat experience book: " + book_path);
         }
-        
-        auto moves = generate_moves(board, current_player);
-        
-        // Check if game is over
-        if (moves.empty()) {
-            auto opponent_moves = generate_moves(board, opponent);
-            if (opponent_moves.empty()) {
-                int score = evaluate(board, player);
-                tt.store(hash, depth, score, 0, best_move);
-                return score;
-            }
-            // Current player has no moves, switch
-            return minimax(board, depth - 1, alpha, beta, !maximizing, player, best_move);
+        bool fresh = st.st_size == 0;
+        if (fresh && ftruncate(fd, sizeof(Header) + cap * sizeof(Entry)) != 0) {
+            close();
+            throw std::runtime_error("cannot size experience book: " + book_path);
         }
-        
-        // Move ordering
-        order_moves(moves, board, current_player);
-        
-        if (maximizing) {
-            int max_eval = std::numeric_limits<int>::min();
-            Move local_best;
-            
-            for (const auto& move : moves) {
-                make_move(board, move, current_player);
-                Move dummy;
-                int eval = minimax(board, depth - 1, alpha, beta, false, player, dummy);
-                unmake_move(board, move, current_player);
-                
-                if (eval > max_eval) {
-                    max_eval = eval;
-                    local_best = move;
-                }
-                
-                alpha = std::max(alpha, eval);
-                if (beta <= alpha) {
-                    break;  // Beta cutoff
-                }
+        if (!fresh) {
+            Header existing;
+            if (pread(fd, &existing, sizeof(existing), 0) != sizeof(existing) ||
+                std::memcmp(existing.magic, MAGIC, sizeof(MAGIC)) != 0) {
+                close();
+                throw std::runtime_error("not an experience book: " + book_path);
             }
-            
-            best_move = local_best;
-            tt.store(hash, depth, max_eval, alpha >= beta ? 1 : 0, best_move);
-            return max_eval;
-        } else {
-            int min_eval = std::numeric_limits<int>::max();
-            Move local_best;
-            
-            for (const auto& move : moves) {
-                make_move(board, move, current_player);
-                Move dummy;
-                int eval = minimax(board, depth - 1, alpha, beta, true, player, dummy);
-                unmake_move(board, move, current_player);
-                
-                if (eval < min_eval) {
-                    min_eval = eval;
-                    local_best = move;
-                }
-                
-                beta = std::min(beta, eval);
-                if (beta <= alpha) {
-                    break;  // Alpha cutoff
-                }
+            // Probing masks with the capacity, and a file shorter than the
+            // table would fault on first access instead of failing here
+            cap = existing.capacity;
+            uint64_t max_cap = (static_cast<uint64_t>(st.st_size) - sizeof(Header)) / sizeof(Entry);
+            if (cap < 1024 || (cap & (cap - 1)) != 0 || cap > max_cap ||
+                static_cast<uint64_t>(st.st_size) != sizeof(Header) + cap * sizeof(Entry) ||
+                existing.count > cap) {
+                close();
+                throw std::runtime_error("damaged experience book: " + book_path);
             }
-            
-            best_move = local_best;
-            tt.store(hash, depth, min_eval, alpha >= beta ? 2 : 0, best_move);
-            return min_eval;
         }
+        
+        mapped_bytes = sizeof(Header) + cap * sizeof(Entry);
+        void* base = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            close();
+            throw std::runtime_error("cannot map experience book: " + book_path);
+        }
+        header = static_cast<Header*>(base);
+        entries = reinterpret_cast<Entry*>(header + 1);
+        if (fresh) {
+            std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+            header->capacity = cap;
+        }
+        path = book_path;
     }
     
-public:
-    SearchEngine() : nodes_evaluated(0) {}
+    void close() {
+        if (header) {
+            munmap(header, mapped_bytes);
+            header = nullptr;
+            entries = nullptr;
+        }
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
     
-    // Python interface: find best move
-    py::tuple find_best_move(py::list board_2d, int board_size, int player, int depth) {
-        nodes_evaluated = 0;
+    bool is_open() const {
+        return header != nullptr;
+    }
+    
+    const Entry* lookup(uint64_t key) {
+        return is_open() ? find(key, false) : nullptr;
+    }
+    
+    void append(const std::vector<LogRecord>& records) {
+        int log_fd = ::open((path + ".log").c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (log_fd < 0) {
+            throw std::runtime_error("cannot open experience log: " + path + ".log");
+        }
+        // One write per game so concurrent appenders never interleave
+        // records, under a shared lock so a merge never truncates it away
+        size_t bytes = records.size() * sizeof(LogRecord);
+        ssize_t written = flock(log_fd, LOCK_SH) == 0 ? write(log_fd, records.data(), bytes) : -1;
+        ::close(log_fd);
+        if (written != static_cast<ssize_t>(bytes)) {
+            throw std::runtime_error("short write to experience log: " + path + ".log");
+        }
+    }
+    
+    // Fold the append log into the table and truncate it. Returns the
+    // number of records merged.
+    size_t merge_log() {
+        std::string log_path = path + ".log";
+        int log_fd = ::open(log_path.c_str(), O_RDWR);
+        if (log_fd < 0) {
+            return 0;
+        }
+        // Appenders wait while the log is read and truncated, so no record
+        // lands in between and is lost
+        std::vector<LogRecord> records;
+        struct stat st;
+        bool taken = flock(log_fd, LOCK_EX) == 0 && fstat(log_fd, &st) == 0;
+        if (taken) {
+            records.resize(st.st_size / sizeof(LogRecord));
+            size_t bytes = records.size() * sizeof(LogRecord);
+            taken = pread(log_fd, records.data(), bytes, 0) == static_cast<ssize_t>(bytes) &&
+                    ftruncate(log_fd, 0) == 0;
+        }
+        ::close(log_fd);
+        if (!taken) {
+            return 0;
+        }
+        
+        for (const LogRecord& record : records) {
+            Entry* child = find(record.child_key, true);
+            double before = average(child);
+            if (child) {
+                child->visits++;
+                child->score_sum += record.outcome;
+            }
+            Entry* parent = find(record.parent_key, true);
+            if (parent && child) {
+                add_edge(record.parent_key, record.child_key, record.move);
+                const Entry* best = parent->best_child ? find(parent->best_child, false) : nullptr;
+                if (!best || average(child) > average(best)) {
+                    parent->best_child = record.child_key;
+                    parent->best_move = record.move;
+                } else if (best == child && average(child) < before) {
+                    rescan(parent, record.parent_key);
+                }
+            }
+        }
+        return records.size();
+    }
+    
+    uint64_t count() const {
+        return is_open() ? header->count : 0;
+    }
+    
+    uint64_t capacity() const {
+        return is_open() ? header->capacity : 0;
+    }
+};
+
+// Search request log for replaying production traffic as a benchmark
+// workload: a magic string followed by one record per request, each a
+// fixed header and then board_size^2 cells (player * 100 + value, 0 empty).
+// Records are appended with a single write, so several engines (or
+// processes) can share a log.
+class RequestLog {
+public:
+    enum Mode : uint8_t { TWO_PLAYER = 0, PARANOID = 1, MAXN = 2 };
+    
+    struct Header {
+        uint64_t arrival_us;  // wall clock, microseconds since the epoch
+        uint64_t nodes;
+        uint8_t board_size;
+        uint8_t num_players;
+        uint8_t player;
+        uint8_t depth;
+        uint8_t threads;
+        uint8_t mode;
+        uint16_t reserved;
+    };
+    
+    struct Request {
+        Header header;
+        BoardState board;
+    };
+    
+    static constexpr char MAGIC[8] = {'S', 'Q', 'X', 'R', 'E', 'Q', 'S', '1'};
+    
+private:
+    int fd = -1;
+    std::string path;
+    
+public:
+    RequestLog() = default;
+    RequestLog(const RequestLog&) = delete;
+    RequestLog& operator=(const RequestLog&) = delete;
+    
+    ~RequestLog() {
+        close();
+    }
+    
+    void open(const std::string& log_path) {
+        close();
+        fd = ::open(log_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open request log: " + log_path);
+        }
+        struct stat st;
+        fstat(fd, &st);
+        if (st.st_size == 0 && write(fd, MAGIC, sizeof(MAGIC)) != sizeof(MAGIC)) {
+            close();
+            throw std::runtime_error("cannot write request log: " + log_path);
+        }
+        path = log_path;
+    }
+    
+    void close() {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    
+    bool is_open() const {
+        return fd >= 0;
+    }
+    
+    void record(const BoardState& board, int player, int depth, uint64_t nodes, int threads,
+                Mode mode) {
+        Header header{};
+        header.arrival_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        header.nodes = nodes;
+        header.board_size = static_cast<uint8_t>(board.size);
+        header.num_players = static_cast<uint8_t>(board.num_players);
+        header.player = static_cast<uint8_t>(player);
+        header.depth = static_cast<uint8_t>(std::min(depth, 255));
+        header.threads = static_cast<uint8_t>(std::max(1, std::min(threads, 255)));
+        header.mode = mode;
+        
+        char buffer[sizeof(Header) + MAX_BOARD_SIZE * MAX_BOARD_SIZE * sizeof(uint16_t)];
+        std::memcpy(buffer, &header, sizeof(header));
+        uint16_t* cells = reinterpret_cast<uint16_t*>(buffer + sizeof(Header));
+        for (int r = 0; r < board.size; ++r) {
+            for (int c = 0; c < board.size; ++c) {
+                *cells++ = static_cast<uint16_t>(board.board[r][c]);
+            }
+        }
+        size_t bytes = reinterpret_cast<char*>(cells) - buffer;
+        if (write(fd, buffer, bytes) != static_cast<ssize_t>(bytes)) {
+            throw std::runtime_error("short write to request log: " + path);
+        }
+    }
+    
+    // Read every request in a log, in arrival order
+    static std::vector<Request> load(const std::string& log_path) {
+        std::ifstream in(log_path, std::ios::binary);
+        char magic[8];
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("not a request log: " + log_path);
+        }
+        
+        std::vector<Request> requests;
+        Header header;
+        while (in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            if (header.board_size < 1 || header.board_size > MAX_BOARD_SIZE ||
+                header.num_players < 2 || header.num_players > MAX_PLAYERS) {
+                throw std::runtime_error("corrupt request log: " + log_path);
+            }
+            Request request{header, BoardState(header.board_size, header.num_players)};
+            uint16_t cells[MAX_BOARD_SIZE * MAX_BOARD_SIZE];
+            int count = header.board_size * header.board_size;
+            if (!in.read(reinterpret_cast<char*>(cells), count * sizeof(uint16_t))) {
+                break;  // truncated final record
+            }
+            for (int k = 0; k < count; ++k) {
+                int owner = cells[k] / 100;
+                if (cells[k] && (owner < 1 || owner > header.num_players)) {
+                    throw std::runtime_error("corrupt request log: " + log_path);
+                }
+                if (cells[k]) {
+                    request.board.set_cell(k / header.board_size, k % header.board_size,
+                                           cells[k] / 100, cells[k] % 100);
+                }
+            }
+            requests.push_back(request);
+        }
+        std::stable_sort(requests.begin(), requests.end(), [](const Request& a, const Request& b) {
+            return a.header.arrival_us < b.header.arrival_us;
+        });
+        return requests;
+    }
+};
+
+// Game phase by filled fraction of the board: 0 opening, 1 middlegame, 2 endgame
+constexpr int NUM_PHASES = 3;
+
+inline int game_phase(const BoardState& board) {
+    return std::min(NUM_PHASES - 1,
+                    popcount(board.occupancy[0]) * NUM_PHASES / (board.size * board.size));
+}
+
+// Learned move-ordering priors per board size, indexed by game phase,
+// square and value delta (move value minus the mover's current max value,
+// clamped to [MIN_DELTA, MAX_DELTA]). Scores are smoothed cutoff rates
+// gathered offline (see train_ordering.py) from cutoff statistics.
+class MoveOrderingTables {
+public:
+    static constexpr int MIN_DELTA = -7;
+    static constexpr int MAX_DELTA = 1;
+    static constexpr int NUM_DELTAS = MAX_DELTA - MIN_DELTA + 1;
+    static constexpr int ENTRIES = NUM_PHASES * MAX_CELLS * NUM_DELTAS;
+    static constexpr int SCALE = 100000;
+    
+    // Counts collected during search, weighted by remaining depth squared
+    // so cutoffs near the root (which save the most nodes) dominate
+    struct Stats {
+        std::vector<uint64_t> tried;
+        std::vector<uint64_t> cutoffs;
+        uint64_t cutoff_nodes = 0;       // nodes that ended in a cutoff
+        uint64_t first_move_cutoffs = 0; // ... where the first move already cut
+        
+        Stats() : tried((MAX_BOARD_SIZE + 1) * ENTRIES), cutoffs((MAX_BOARD_SIZE + 1) * ENTRIES) {}
+    };
+    
+private:
+    std::vector<int32_t> priors[MAX_BOARD_SIZE + 1];
+    
+public:
+    static int index(int phase, int sq, int delta) {
+        delta = std::min(std::max(delta, MIN_DELTA), MAX_DELTA) - MIN_DELTA;
+        return (phase * MAX_CELLS + sq) * NUM_DELTAS + delta;
+    }
+    
+    bool has(int size) const {
+        return !priors[size].empty();
+    }
+    
+    int prior(int size, int index) const {
+        return priors[size][index];
+    }
+    
+    // Tables from collected counts, for every board size with data
+    void build(const Stats& stats) {
+        for (int size = 0; size <= MAX_BOARD_SIZE; ++size) {
+            const uint64_t* tried = &stats.tried[size * ENTRIES];
+            const uint64_t* cutoffs = &stats.cutoffs[size * ENTRIES];
+            if (std::all_of(tried, tried + ENTRIES, [](uint64_t t) { return t == 0; })) {
+                continue;
+            }
+            priors[size].resize(ENTRIES);
+            for (int i = 0; i < ENTRIES; ++i) {
+                // Laplace smoothing keeps unseen contexts at an even rate
+                priors[size][i] = static_cast<int32_t>((cutoffs[i] + 1) * SCALE / (tried[i] + 2));
+            }
+        }
+    }
+    
+    // Text format: a header line, then "size phase square p0 .. p8" per row
+    void save(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            throw std::runtime_error("cannot write ordering tables: " + path);
+        }
+        out << "sequencium-ordering 1 " << NUM_PHASES << " " << NUM_DELTAS << "\n";
+        for (int size = 0; size <= MAX_BOARD_SIZE; ++size) {
+            if (!has(size)) continue;
+            for (int phase = 0; phase < NUM_PHASES; ++phase) {
+                for (int sq = 0; sq < MAX_CELLS; ++sq) {
+                    if (sq / MAX_BOARD_SIZE >= size || sq % MAX_BOARD_SIZE >= size) continue;
+                    out << size << " " << phase << " " << sq;
+                    for (int d = 0; d < NUM_DELTAS; ++d) {
+                        out << " " << priors[size][index(phase, sq, MIN_DELTA + d)];
+                    }
+                    out << "\n";
+                }
+            }
+        }
+    }
+    
+    void load(const std::string& path) {
+        std::ifstream in(path);
+        std::string magic;
+        int version = 0, phases = 0, deltas = 0;
+        if (!(in >> magic >> version >> phases >> deltas) || magic != "sequencium-ordering" ||
+            version != 1 || phases != NUM_PHASES || deltas != NUM_DELTAS) {
+            throw std::runtime_error("not a version 1 ordering table file: " + path);
+        }
+        for (auto& table : priors) {
+            table.clear();
+        }
+        int size, phase, sq;
+        while (in >> size >> phase >> sq) {
+            if (size < 1 || size > MAX_BOARD_SIZE || phase < 0 || phase >= NUM_PHASES ||
+                sq < 0 || sq >= MAX_CELLS) {
+                throw std::runtime_error("bad row in ordering tables: " + path);
+            }
+            if (priors[size].empty()) {
+                priors[size].assign(ENTRIES, SCALE / 2);
+            }
+            for (int d = 0; d < NUM_DELTAS; ++d) {
+                in >> priors[size][index(phase, sq, MIN_DELTA + d)];
+            }
+        }
+    }
+};
+
+// Tunable search constants. The defaults are the original hand-set values;
+// tune_spsa.py tunes them by self-play and writes a parameter file.
+struct SearchParams {
+    int max_value_weight = 100;  // evaluation: max value difference
+    int cell_weight = 10;        // evaluation: cell count difference
+    int mobility_weight = 1;     // evaluation: mobility difference
+    int center_weight = 10;      // move ordering: bonus per step nearer the centre
+    
+    // Declared parameters with their tuning range and SPSA perturbation size
+    struct Spec {
+        const char* name;
+        int SearchParams::*field;
+        int min;
+        int max;
+        int step;
+    };
+    
+    static const std::vector<Spec>& specs() {
+        static const std::vector<Spec> table = {
+            {"max_value_weight", &SearchParams::max_value_weight, 1, 1000, 10},
+            {"cell_weight", &SearchParams::cell_weight, 0, 200, 2},
+            {"mobility_weight", &SearchParams::mobility_weight, 0, 100, 1},
+            {"center_weight", &SearchParams::center_weight, 0, 1000, 4},
+        };
+        return table;
+    }
+    
+    void set(const std::string& name, int value) {
+        for (const auto& spec : specs()) {
+            if (name == spec.name) {
+                this->*spec.field = std::min(std::max(value, spec.min), spec.max);
+                return;
+            }
+        }
+        throw std::invalid_argument("unknown search parameter: " + name);
+    }
+    
+    void set(const std::map<std::string, int>& values) {
+        for (const auto& entry : values) {
+            set(entry.first, entry.second);
+        }
+    }
+    
+    std::map<std::string, int> values() const {
+        std::map<std::string, int> result;
+        for (const auto& spec : specs()) {
+            result[spec.name] = this->*spec.field;
+        }
+        return result;
+    }
+    
+    // Text format: a header line, then "name value" per parameter. Missing
+    // parameters keep their defaults.
+    void save(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            throw std::runtime_error("cannot write search parameters: " + path);
+        }
+        out << "sequencium-params 1\n";
+        for (const auto& spec : specs()) {
+            out << spec.name << " " << this->*spec.field << "\n";
+        }
+    }
+    
+    void load(const std::string& path) {
+        std::ifstream in(path);
+        std::string magic;
+        int version = 0;
+        if (!(in >> magic >> version) || magic != "sequencium-params" || version != 1) {
+            throw std::runtime_error("not a version 1 search parameter file: " + path);
+        }
+        SearchParams loaded;
+        std::string name;
+        int value;
+        while (in >> name >> value) {
+            loaded.set(name, value);
+        }
+        *this = loaded;
+    }
+};
+
+// Cells of mask 8-connected to seed
+inline Bitboard flood_fill(Bitboard seed, Bitboard mask, const BoardMasks& masks) {
+    Bitboard region = seed;
+    while (true) {
+        Bitboard grown = dilate(region, masks) & mask;
+        if (grown == region) {
+            return region;
+        }
+        region = grown;
+    }
+}
+
+// Empty regions of a position (8-connected components of empty cells),
+// kept up to date by make_move/unmake_move with rollback, so "are the
+// players separated?" and "which region is this cell in?" are O(1).
+// Filling a cell can only split regions, never join them, so a union-find
+// (which only merges) does not fit; instead each region is a bitboard with
+// a label per cell. A move whose empty neighbours stay connected around it
+// cannot split its region, which is the common case and costs a few bit
+// operations. Otherwise the region is re-flooded and any split-off parts
+// get new labels. Changes are undone in LIFO order, as search requires.
+class RegionTracker {
+public:
+    static constexpr int NONE = -1;
+    
+private:
+    struct Change {
+        int square;
+        int region;
+        int first_new_region;  // labels from here up were split off by this move
+        Bitboard old_mask;
+        bool was_contested;
+    };
+    
+    // Labels in use never exceed the empty cells (live regions) plus the
+    // moves made (regions emptied by a move keep their label until undone)
+    static constexpr int MAX_LABELS = 2 * MAX_CELLS;
+    
+    const BoardMasks* masks = &board_masks(0);
+    int num_players = 2;
+    Bitboard region_mask[MAX_LABELS];
+    bool region_contested[MAX_LABELS];
+    int16_t label[MAX_CELLS];
+    int num_labels = 0;
+    int contested = 0;  // regions reachable by two or more players
+    std::vector<Change> undo;
+    
+    Bitboard flood(Bitboard seed, Bitboard mask) const {
+        return flood_fill(seed, mask, *masks);
+    }
+    
+    void set_contested(int region, const BoardState& board) {
+        int touching = 0;
+        for (int p = 1; p <= num_players; ++p) {
+            touching += (dilate(board.occupancy[p], *masks) & region_mask[region]) != 0;
+        }
+        bool now = touching >= 2;
+        contested += static_cast<int>(now) - static_cast<int>(region_contested[region]);
+        region_contested[region] = now;
+    }
+    
+    int new_region(Bitboard mask) {
+        int region = num_labels++;
+        region_mask[region] = mask;
+        region_contested[region] = false;
+        Bitboard cells = mask;
+        while (cells) {
+            label[pop_lsb(cells)] = static_cast<int16_t>(region);
+        }
+        return region;
+    }
+    
+public:
+    // Label every empty region of board from scratch
+    void reset(const BoardState& board) {
+        masks = &board_masks(board.size);
+        num_players = board.num_players;
+        num_labels = 0;
+        contested = 0;
+        undo.clear();
+        std::fill(label, label + MAX_CELLS, static_cast<int16_t>(NONE));
+        
+        Bitboard empty = masks->full & ~board.occupancy[0];
+        while (empty) {
+            Bitboard seed = square_bit(pop_lsb(empty));
+            Bitboard region = flood(seed, masks->full & ~board.occupancy[0]);
+            empty &= ~region;
+            set_contested(new_region(region), board);
+        }
+    }
+    
+    // Update for a move just made on board at square sq
+    void make_move(const BoardState& board, int sq) {
+        int region = label[sq];
+        Change change{sq, region, num_labels, region_mask[region], region_contested[region]};
+        undo.push_back(change);
+        label[sq] = static_cast<int16_t>(NONE);
+        
+        Bitboard rest = region_mask[region] & ~square_bit(sq);
+        Bitboard near = masks->neighbors[sq] & rest;
+        region_mask[region] = rest;
+        
+        // Empty neighbours connected around sq: the region cannot have split
+        if (near && flood(near & -near, near) != near) {
+            Bitboard kept = flood(near & -near, rest);
+            if (kept != rest) {
+                region_mask[region] = kept;
+                Bitboard remaining = rest & ~kept;
+                while (remaining) {
+                    // Every split-off part contains one of sq's neighbours
+                    Bitboard seed = near & remaining;
+                    Bitboard part = flood(seed & -seed, remaining);
+                    remaining &= ~part;
+                    set_contested(new_region(part), board);
+                }
+            }
+        }
+        set_contested(region, board);
+    }
+    
+    void unmake_move() {
+        const Change& change = undo.back();
+        for (int split = num_labels - 1; split >= change.first_new_region; --split) {
+            contested -= region_contested[split];
+            Bitboard cells = region_mask[split];
+            while (cells) {
+                label[pop_lsb(cells)] = static_cast<int16_t>(change.region);
+            }
+        }
+        num_labels = change.first_new_region;
+        contested += static_cast<int>(change.was_contested) -
+                     static_cast<int>(region_contested[change.region]);
+        region_contested[change.region] = change.was_contested;
+        region_mask[change.region] = change.old_mask;
+        label[change.square] = static_cast<int16_t>(change.region);
+        undo.pop_back();
+    }
+    
+    // True once no empty region can be reached by more than one player
+    bool separated() const {
+        return contested == 0;
+    }
+    
+    // Region label of an empty square, or NONE for an occupied one
+    int region_of(int sq) const {
+        return label[sq];
+    }
+    
+    Bitboard region_cells(int sq) const {
+        return label[sq] == NONE ? 0 : region_mask[label[sq]];
+    }
+    
+    int region_count() const {
+        int count = 0;
+        for (int region = 0; region < num_labels; ++region) {
+            count += region_mask[region] != 0;
+        }
+        return count;
+    }
+};
+
+// Region-shape database: for every region shape (cells connected by the
+// game's eight-way adjacency) of up to max_cells cells, the longest simple
+// path (in cells) starting from each of its cells. In a closed region a
+// player enters at one cell, so the best chain through it is the entry
+// value plus that length minus one, and one lookup replaces the exponential
+// path search. Shapes are stored under a canonical form (least encoding
+// over the 8 rotations and reflections) in a memory-mapped open-addressing
+// table built offline by build(). Lookups are read-only and thread-safe.
+class RegionShapeDB {
+public:
+    static constexpr int MAX_SHAPE_CELLS = 16;
+    
+    // Shape key: height (4 bits) | width (4 bits) | cell grid, row-major (120 bits)
+    using Key = unsigned __int128;
+    
+    struct Entry {
+        uint64_t key_lo;
+        uint64_t key_hi;
+        uint8_t length[MAX_SHAPE_CELLS];  // per cell in row-major order of the grid
+    };
+    
+private:
+    struct Header {
+        char magic[8];
+        uint32_t max_cells;
+        uint32_t reserved;
+        uint64_t capacity;
+        uint64_t count;
+    };
+    
+    static constexpr char MAGIC[8] = {'S', 'Q', 'X', 'S', 'H', 'A', 'P', '1'};
+    
+    int fd = -1;
+    size_t mapped_bytes = 0;
+    const Header* header = nullptr;
+    const Entry* entries = nullptr;
+    
+    static uint64_t slot_hash(Key key) {
+        return mix64(static_cast<uint64_t>(key) ^ mix64(static_cast<uint64_t>(key >> 64)));
+    }
+    
+    static int shape_height(Key key) { return static_cast<int>(key >> 124); }
+    static int shape_width(Key key) { return static_cast<int>((key >> 120) & 15); }
+    
+    // Canonical key of n cells given as (row, col); index is set to the
+    // position of cells[start] among the canonical shape's cells
+    static Key canonical(const std::pair<int, int>* cells, int n, int start, int& index) {
+        Key best = 0;
+        for (int t = 0; t < 8; ++t) {
+            int min_r = 1 << 20, min_c = 1 << 20, max_r = -(1 << 20), max_c = -(1 << 20);
+            std::array<std::pair<int, int>, MAX_SHAPE_CELLS> moved;
+            for (int i = 0; i < n; ++i) {
+                int r = cells[i].first, c = cells[i].second;
+                if (t & 4) std::swap(r, c);
+                if (t & 2) r = -r;
+                if (t & 1) c = -c;
+                moved[i] = {r, c};
+                min_r = std::min(min_r, r);
+                min_c = std::min(min_c, c);
+                max_r = std::max(max_r, r);
+                max_c = std::max(max_c, c);
+            }
+            int h = max_r - min_r + 1, w = max_c - min_c + 1;
+            if (h > MAX_BOARD_SIZE || w > MAX_BOARD_SIZE) {
+                return 0;  // cannot occur on a board
+            }
+            Key grid = 0;
+            for (int i = 0; i < n; ++i) {
+                grid |= static_cast<Key>(1) << ((moved[i].first - min_r) * w + moved[i].second - min_c);
+            }
+            Key key = (static_cast<Key>(h) << 124) | (static_cast<Key>(w) << 120) | grid;
+            if (t == 0 || key < best) {
+                best = key;
+                int bit = (moved[start].first - min_r) * w + moved[start].second - min_c;
+                index = popcount(grid & ((static_cast<Key>(1) << bit) - 1));
+            }
+        }
+        return best;
+    }
+    
+    static std::vector<std::pair<int, int>> decode(Key key) {
+        std::vector<std::pair<int, int>> cells;
+        int w = shape_width(key);
+        Bitboard grid = key & ((static_cast<Key>(1) << 120) - 1);
+        while (grid) {
+            int bit = pop_lsb(grid);
+            cells.emplace_back(bit / w, bit % w);
+        }
+        return cells;
+    }
+    
+    static void longest_path(const std::array<uint32_t, MAX_SHAPE_CELLS>& adjacent, int cell,
+                             uint32_t visited, int length, int total, int& best) {
+        best = std::max(best, length);
+        if (best == total) {
+            return;
+        }
+        uint32_t next = adjacent[cell] & ~visited;
+        while (next) {
+            int step = __builtin_ctz(next);
+            next &= next - 1;
+            longest_path(adjacent, step, visited | (1u << step), length + 1, total, best);
+        }
+    }
+    
+    // Longest path from every cell of a (canonical) shape
+    static Entry solve(Key key) {
+        Entry entry{};
+        entry.key_lo = static_cast<uint64_t>(key);
+        entry.key_hi = static_cast<uint64_t>(key >> 64);
+        auto cells = decode(key);
+        int n = static_cast<int>(cells.size());
+        std::array<uint32_t, MAX_SHAPE_CELLS> adjacent{};
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                int dr = std::abs(cells[i].first - cells[j].first);
+                int dc = std::abs(cells[i].second - cells[j].second);
+                if (i != j && dr <= 1 && dc <= 1) adjacent[i] |= 1u << j;
+            }
+        }
+        for (int i = 0; i < n; ++i) {
+            int best = 0;
+            longest_path(adjacent, i, 1u << i, 1, n, best);
+            entry.length[i] = static_cast<uint8_t>(best);
+        }
+        return entry;
+    }
+    
+    const Entry* find(Key key) const {
+        uint64_t mask = header->capacity - 1;
+        for (uint64_t i = slot_hash(key) & mask;; i = (i + 1) & mask) {
+            const Entry& entry = entries[i];
+            if (entry.key_lo == static_cast<uint64_t>(key) &&
+                entry.key_hi == static_cast<uint64_t>(key >> 64)) {
+                return &entry;
+            }
+            if (entry.key_lo == 0 && entry.key_hi == 0) {
+                return nullptr;
+            }
+        }
+    }
+    
+public:
+    RegionShapeDB() = default;
+    RegionShapeDB(const RegionShapeDB&) = delete;
+    RegionShapeDB& operator=(const RegionShapeDB&) = delete;
+    
+    ~RegionShapeDB() {
+        close();
+    }
+    
+    // Enumerate all shapes up to max_cells (growing each shape of one size
+    // by a neighbouring cell), solve them and write the table. Returns the
+    // number of shapes.
+    static uint64_t build(const std::string& path, int max_cells) {
+        if (max_cells < 1 || max_cells > MAX_SHAPE_CELLS) {
+            throw std::invalid_argument("max_cells must be between 1 and " +
+                                        std::to_string(MAX_SHAPE_CELLS));
+        }
+        struct KeyHash {
+            size_t operator()(Key key) const { return slot_hash(key); }
+        };
+        std::vector<Key> shapes;
+        std::vector<Key> level = {(static_cast<Key>(1) << 124) | (static_cast<Key>(1) << 120) | 1};
+        for (int size = 1; size <= max_cells; ++size) {
+            shapes.insert(shapes.end(), level.begin(), level.end());
+            if (size == max_cells) break;
+            std::unordered_set<Key, KeyHash> next;
+            for (Key key : level) {
+                auto cells = decode(key);
+                for (size_t i = 0; i < cells.size(); ++i) {
+                    for (int d = 0; d < 9; ++d) {
+                        std::pair<int, int> cell(cells[i].first + d / 3 - 1, cells[i].second + d % 3 - 1);
+                        if (std::find(cells.begin(), cells.end(), cell) != cells.end()) continue;
+                        auto grown = cells;
+                        grown.push_back(cell);
+                        int index;
+                        Key canon = canonical(grown.data(), static_cast<int>(grown.size()), 0, index);
+                        if (canon) next.insert(canon);
+                    }
+                }
+            }
+            level.assign(next.begin(), next.end());
+            std::sort(level.begin(), level.end());
+        }
+        
+        uint64_t capacity = 1024;
+        while (capacity < shapes.size() * 10 / 7) capacity <<= 1;
+        std::vector<Entry> table(capacity);
+        for (Key key : shapes) {
+            Entry entry = solve(key);
+            for (uint64_t i = slot_hash(key) & (capacity - 1);; i = (i + 1) & (capacity - 1)) {
+                if (table[i].key_lo == 0 && table[i].key_hi == 0) {
+                    table[i] = entry;
+                    break;
+                }
+            }
+        }
+        
+        Header out{};
+        std::memcpy(out.magic, MAGIC, sizeof(MAGIC));
+        out.max_cells = static_cast<uint32_t>(max_cells);
+        out.capacity = capacity;
+        out.count = shapes.size();
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&out), sizeof(out));
+        file.write(reinterpret_cast<const char*>(table.data()), capacity * sizeof(Entry));
+        if (!file) {
+            throw std::runtime_error("cannot write region shape database: " + path);
+        }
+        return shapes.size();
+    }
+    
+    void open(const std::string& path) {
+        close();
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open region shape database: " + path);
+        }
+        Header existing;
+        struct stat st;
+        if (fstat(fd, &st) != 0 ||
+            pread(fd, &existing, sizeof(existing), 0) != sizeof(existing) ||
+            std::memcmp(existing.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            static_cast<uint64_t>(st.st_size) != sizeof(Header) + existing.capacity * sizeof(Entry)) {
+            close();
+            throw std::runtime_error("not a region shape database: " + path);
+        }
+        mapped_bytes = st.st_size;
+        void* base = mmap(nullptr, mapped_bytes, PROT_READ, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            close();
+            throw std::runtime_error("cannot map region shape database: " + path);
+        }
+        header = static_cast<const Header*>(base);
+        entries = reinterpret_cast<const Entry*>(header + 1);
+    }
+    
+    void close() {
+        if (header) {
+            munmap(const_cast<Header*>(header), mapped_bytes);
+            header = nullptr;
+            entries = nullptr;
+        }
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    
+    bool is_open() const {
+        return header != nullptr;
+    }
+    
+    int max_cells() const {
+        return header ? static_cast<int>(header->max_cells) : 0;
+    }
+    
+    uint64_t shapes() const {
+        return header ? header->count : 0;
+    }
+    
+    // Longest path (in cells) from sq through the connected region, if the
+    // region is small enough to be in the database
+    bool lookup(Bitboard region, int sq, int& length) const {
+        int n = popcount(region);
+        if (!header || n > static_cast<int>(header->max_cells)) {
+            return false;
+        }
+        std::array<std::pair<int, int>, MAX_SHAPE_CELLS> cells;
+        int count = 0, start = 0;
+        while (region) {
+            int cell = pop_lsb(region);
+            if (cell == sq) start = count;
+            cells[count++] = {cell / MAX_BOARD_SIZE, cell % MAX_BOARD_SIZE};
+        }
+        int index;
+        const Entry* entry = find(canonical(cells.data(), n, start, index));
+        if (!entry) {
+            return false;
+        }
+        length = entry->length[index];
+        return true;
+    }
+};
+
+// Database consulted by every ChainSolver once opened
+inline RegionShapeDB& region_shapes() {
+    static RegionShapeDB db;
+    return db;
+}
+
+py::dict region_db_stats() {
+    py::dict stats;
+    stats["open"] = region_shapes().is_open();
+    stats["max_cells"] = region_shapes().max_cells();
+    stats["shapes"] = region_shapes().shapes();
+    return stats;
+}
+
+py::dict build_region_db(const std::string& path, int max_cells) {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t shapes = RegionShapeDB::build(path, max_cells);
+    py::dict stats;
+    stats["max_cells"] = max_cells;
+    stats["shapes"] = shapes;
+    stats["seconds"] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+// Exact play once the players are separated (RegionTracker::separated):
+// nobody can interfere with anyone else any more, so a player's final max
+// value is the longest chain they can extend into their own regions,
+// whatever the move order. Chains are simple paths found by depth-first
+// search, pruned by the size of the area still reachable. solve() gives up
+// (returns false) after budget nodes.
+class ChainSolver {
+private:
+    const BoardMasks& masks;
+    uint64_t budget;
+    uint64_t nodes = 0;
+    
+    // Longest simple path (counted in cells, sq included) from sq through free
+    void extend(int sq, Bitboard free, int length, int& best) {
+        if (++nodes > budget) {
+            return;
+        }
+        best = std::max(best, length);
+        Bitboard next = masks.neighbors[sq] & free;
+        if (!next || length + popcount(flood_fill(next, free, masks)) <= best) {
+            return;
+        }
+        while (next) {
+            int step = pop_lsb(next);
+            extend(step, free & ~square_bit(step), length + 1, best);
+            if (nodes > budget) {
+                return;
+            }
+        }
+    }
+    
+public:
+    ChainSolver(int board_size, uint64_t node_budget)
+        : masks(board_masks(board_size)), budget(node_budget) {}
+    
+    uint64_t get_nodes() const {
+        return nodes;
+    }
+    
+    // Best final max value for player among the given legal moves (higher
+    // values first), and the move that starts the chain reaching it
+    bool solve(const BoardState& board, int player, const std::vector<Move>& moves,
+               int& final_max, Move& first) {
+        final_max = board.player_max_values[player];
+        first = moves.empty() ? Move() : moves[0];
+        Bitboard empty = masks.full & ~board.occupancy[0];
+        for (const auto& move : moves) {
+            int sq = move.row * MAX_BOARD_SIZE + move.col;
+            Bitboard region = flood_fill(square_bit(sq), empty, masks);
+            if (move.value + popcount(region) - 1 <= final_max) {
+                continue;  // cannot beat the best chain so far
+            }
+            int length = 0;
+            if (region_shapes().lookup(region, sq, length)) {
+                ++nodes;
+            } else {
+                extend(sq, region & ~square_bit(sq), 1, length);
+            }
+            if (nodes > budget) {
+                return false;
+            }
+            if (move.value + length - 1 > final_max) {
+                final_max = move.value + length - 1;
+                first = move;
+            }
+        }
+        return true;
+    }
+};
+
+// Per-thread search state and the limits shared between search threads
+struct SearchContext {
+    uint64_t nodes = 0;                              // nodes searched by this thread
+    uint64_t node_budget = 0;                        // total for all threads, 0 = unlimited
+    std::atomic<uint64_t>* shared_nodes = nullptr;   // budget counter shared by all threads
+    std::atomic<bool>* stop = nullptr;
+    int completed_depth = 0;
+    MoveOrderingTables::Stats* cutoff_stats = nullptr;  // collected if set
+    bool timed = false;                              // stop at deadline if set
+    std::chrono::steady_clock::time_point deadline;
+    uint64_t tt_probes = 0;
+    uint64_t tt_hits = 0;                            // probes that returned a score
+    uint64_t tt_stores = 0;
+    uint64_t tt_overwrites = 0;                      // stores over another position
+    uint64_t passes = 0;                             // MTD(f) zero-window searches
+};
+
+// State of a search that can be suspended every few nodes and resumed
+// later (possibly on another thread). The recursion of minimax() is kept
+// on an explicit stack of frames.
+struct ResumableSearch {
+    struct Frame {
+        int depth, alpha, beta, to_move;
+        int alpha_orig, beta_orig, best_eval;
+        uint64_t hash;
+        bool pass;               // player to move is blocked: result is the child's
+        std::vector<Move> moves;
+        size_t next_index;       // next child to enter (for a pass, 1 once entered)
+        Move local_best;
+    };
+    
+    BoardState board;
+    int player = 0;
+    int depth = 1;               // iteration in progress
+    int max_depth = 0;
+    uint64_t nodes = 0;
+    uint64_t node_budget = 0;    // 0 = unlimited
+    std::vector<Frame> stack;
+    Move best_move;              // from the last completed iteration
+    int completed_depth = 0;
+    bool finished = false;
+};
+
+// Persistent worker threads for data-parallel batches. run() calls
+// fn(worker, num_workers) on every worker (the caller is worker 0) and
+// returns when all have finished.
+class WorkerPool {
+private:
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable start;
+    std::condition_variable finished;
+    std::function<void(int, int)> job;
+    uint64_t generation = 0;
+    int running = 0;
+    bool stopping = false;
+    
+    void worker_loop(int index) {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            start.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            lock.unlock();
+            job(index, size());
+            lock.lock();
+            if (--running == 0) {
+                finished.notify_one();
+            }
+        }
+    }
+    
+public:
+    explicit WorkerPool(int num_workers) {
+        if (num_workers <= 0) {
+            num_workers = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (int i = 1; i < num_workers; ++i) {
+            threads.emplace_back(&WorkerPool::worker_loop, this, i);
+        }
+    }
+    
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        start.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    
+    int size() const {
+        return static_cast<int>(threads.size()) + 1;
+    }
+    
+    void run(const std::function<void(int, int)>& fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = fn;
+            running = static_cast<int>(threads.size());
+            generation++;
+        }
+        start.notify_all();
+        fn(0, size());
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this] { return running == 0; });
+    }
+    
+    // Split [0, n) into contiguous chunks, one per worker
+    void parallel_for(size_t n, const std::function<void(size_t)>& body) {
+        run([&](int worker, int workers) {
+            size_t begin = n * worker / workers, end = n * (worker + 1) / workers;
+            for (size_t i = begin; i < end; ++i) {
+                body(i);
+            }
+        });
+    }
+};
+
+// Bounded multi-producer multi-consumer queue: a ring of sequenced cells
+// (Vyukov), lock-free with fixed capacity. try_push fails when the queue is
+// full, which is how pipeline stages apply backpressure.
+template <class T>
+class BoundedQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+    
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+    
+public:
+    explicit BoundedQueue(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        cells.reset(new Cell[cap]);
+        mask = cap - 1;
+        for (size_t i = 0; i < cap; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    bool try_push(T& value) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // full
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    bool try_pop(T& value) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // empty
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+// Wait step for a stage blocked on a full or empty queue: yield at first,
+// then sleep briefly so an idle stage does not burn a core
+inline void queue_backoff(int& spins) {
+    if (++spins < 64) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+// Search engine class
+class SearchEngine {
+    friend class SearchScheduler;
+    friend class VectorEnv;
+    friend class AnalysisPipeline;
+    friend class RegionMap;
+    friend class Dispatcher;
+    friend class MctsEngine;
+    friend class TranspositionMcts;
+    friend py::tuple play_match(const std::map<std::string, int>&,
+                                const std::map<std::string, int>&, int, int, int, uint64_t,
+                                int, int, uint64_t);
+    
+private:
+    TranspositionTable tt;
+    uint64_t nodes_evaluated;
+    
+    // Exact-key table used instead of tt on small boards in verified mode
+    std::unique_ptr<VerifiedTable> verified_tt;
+    
+    // Auto-sizing: fraction of the cgroup memory headroom given to the TT (0 = fixed size)
+    double tt_memory_fraction;
+    std::chrono::steady_clock::time_point last_memory_check;
+    
+    // Learned move-ordering priors, and cutoff statistics while collecting
+    MoveOrderingTables ordering;
+    std::unique_ptr<MoveOrderingTables::Stats> cutoff_stats;
+    
+    // Experience book consulted before searching
+    ExperienceBook book;
+    int book_min_visits = 16;
+    int book_hits = 0;
+    
+    // Opt-in log of incoming search requests
+    RequestLog request_log;
+    
+    // Workers for evaluate_batch, kept between calls
+    std::unique_ptr<WorkerPool> batch_pool;
+    
+    // Evaluation weights and ordering constants (see SearchParams)
+    SearchParams params;
+    
+    // Pin search thread i to NUMA node i % nodes (the caller's affinity is
+    // restored afterwards)
+    bool pin_threads = false;
+    
+    // Leaves stop evaluating once the score is decided for the window
+    bool lazy_eval = true;
+    
+    // Root driver of iterative deepening: MTD(f) instead of full-window alpha-beta
+    bool mtdf_driver = false;
+    
+    // Counters of the last parallel_search, summed over its threads
+    struct SearchStats {
+        int threads = 0;
+        int completed_depth = 0;
+        uint64_t nodes = 0;
+        uint64_t main_nodes = 0;
+        uint64_t tt_probes = 0;
+        uint64_t tt_hits = 0;
+        uint64_t tt_stores = 0;
+        uint64_t tt_overwrites = 0;
+        uint64_t passes = 0;
+    } last_search;
+    
+    static constexpr size_t MIN_TT_ENTRIES = 1024;
+    
+    // TT entries allowed by the auto-size fraction, or 0 if no limit is known.
+    // The TT's own memory counts as headroom, since it is ours to give back.
+    size_t auto_tt_entries() const {
+        CgroupMemory mem;
+        if (!read_cgroup_memory(mem)) {
+            return 0;
+        }
+        uint64_t own = tt.memory_bytes();
+        uint64_t usage = mem.usage > own ? mem.usage - own : 0;
+        uint64_t headroom = mem.limit > usage ? mem.limit - usage : 0;
+        size_t entries = static_cast<size_t>(headroom * tt_memory_fraction) / sizeof(TTEntry);
+        return std::max(entries, MIN_TT_ENTRIES);
+    }
+    
+    // Get cell value: returns player*100 + value, or 0 for empty
+    int get_cell(const BoardState& board, int row, int col) const {
+        if (row < 0 || row >= board.size || col < 0 || col >= board.size) {
+            return -1;
+        }
+        return board.board[row][col];
+    }
+    
+    // Extract player from cell value
+    int get_player(int cell_value) const {
+        if (cell_value == 0) return 0;
+        return cell_value / 100;
+    }
+    
+    // Extract value from cell value
+    int get_value(int cell_value) const {
+        if (cell_value == 0) return 0;
+        return cell_value % 100;
+    }
+    
+    // Value of a move to an empty square: one above the player's highest
+    // adjacent cell
+    static int move_value(const BoardState& board, int sq, int player) {
+        int best = 0;
+        Bitboard adjacent = board_masks(board.size).neighbors[sq] & board.occupancy[player];
+        while (adjacent) {
+            best = std::max(best, board.value_at(pop_lsb(adjacent)));
+        }
+        return best + 1;
+    }
+    
+    // Generate valid moves for a player: every empty neighbour of the
+    // player's cells, in square order
+    static std::vector<Move> generate_moves(const BoardState& board, int player) {
+        std::vector<Move> moves;
+        const BoardMasks& masks = board_masks(board.size);
+        Bitboard frontier = dilate(board.occupancy[player], masks) & ~board.occupancy[0];
+        
+        while (frontier) {
+            int sq = pop_lsb(frontier);
+            moves.emplace_back(sq / MAX_BOARD_SIZE, sq % MAX_BOARD_SIZE,
+                               move_value(board, sq, player));
+        }
+        
+        return moves;
+    }
+    
+    // Make a move on the board
+    static void make_move(BoardState& board, const Move& move, int player) {
+        board.set_cell(move.row, move.col, player, move.value);
+    }
+    
+    // Unmake a move
+    static void unmake_move(BoardState& board, const Move& move, int player) {
+        board.board[move.row][move.col] = 0;
+        Bitboard bit = square_bit(move.row * MAX_BOARD_SIZE + move.col);
+        board.occupancy[player] &= ~bit;
+        board.occupancy[0] &= ~bit;
+        
+        // Recompute max value only if the removed cell held it
+        if (move.value < board.player_max_values[player]) {
+            return;
+        }
+        board.player_max_values[player] = 0;
+        Bitboard own = board.occupancy[player];
+        while (own) {
+            int val = board.value_at(pop_lsb(own));
+            if (val > board.player_max_values[player]) {
+                board.player_max_values[player] = val;
+            }
+        }
+    }
+    
+    // Fast mobility count (count potential moves without generating full move list)
+    int count_mobility(const BoardState& board, int player) const {
+        const BoardMasks& masks = board_masks(board.size);
+        return popcount(dilate(board.occupancy[player], masks) & ~board.occupancy[0]);
+    }
+    
+    // Evaluate position
+    int evaluate(const BoardState& board, int player) const {
+        int opponent = (player == PLAYER_A) ? PLAYER_B : PLAYER_A;
+        
+        // Primary: max value difference
+        int max_diff = board.player_max_values[player] - board.player_max_values[opponent];
+        
+        // Secondary: count cells
+        int cell_diff = popcount(board.occupancy[player]) - popcount(board.occupancy[opponent]);
+        
+        // Tertiary: mobility (use fast count)
+        int mobility_diff = count_mobility(board, player) - count_mobility(board, opponent);
+        
+        return max_diff * params.max_value_weight + cell_diff * params.cell_weight +
+               mobility_diff * params.mobility_weight;
+    }
+    
+    // evaluate() for a leaf searched with the window (alpha, beta). Terms are
+    // added cheapest first, and once the rest cannot bring the score back
+    // inside the window the partial score is returned as a bound: flag 1
+    // (lower bound, >= beta) or 2 (upper bound, <= alpha), else 0 (exact).
+    // The unscored cells can shift the cell term by at most the occupied
+    // count and mobility by at most the empty count.
+    int evaluate_lazy(const BoardState& board, int player, int alpha, int beta, int& flag) const {
+        flag = 0;
+        if (board.num_players != 2 || !lazy_eval) {
+            return evaluate_multi(board, player);
+        }
+        int opponent = (player == PLAYER_A) ? PLAYER_B : PLAYER_A;
+        int score = (board.player_max_values[player] - board.player_max_values[opponent]) *
+                    params.max_value_weight;
+        int occupied = popcount(board.occupancy[0]);
+        int empty = board.size * board.size - occupied;
+        
+        int rest = occupied * params.cell_weight + empty * params.mobility_weight;
+        if (score - rest >= beta) {
+            flag = 1;
+            return score - rest;
+        }
+        if (score + rest <= alpha) {
+            flag = 2;
+            return score + rest;
+        }
+        
+        score += (popcount(board.occupancy[player]) - popcount(board.occupancy[opponent])) *
+                 params.cell_weight;
+        rest = empty * params.mobility_weight;
+        if (score - rest >= beta) {
+            flag = 1;
+            return score - rest;
+        }
+        if (score + rest <= alpha) {
+            flag = 2;
+            return score + rest;
+        }
+        
+        return score + (count_mobility(board, player) - count_mobility(board, opponent)) *
+                       params.mobility_weight;
+    }
+    
+    // Evaluate position for any number of players: the player against the
+    // strongest opponent's max value and the opponents' average cells/mobility
+    int evaluate_multi(const BoardState& board, int player) const {
+        int n = board.num_players;
+        if (n == 2) {
+            return evaluate(board, player);
+        }
+        
+        int best_opponent_max = 0, opponent_cells = 0, opponent_mobility = 0;
+        for (int p = 1; p <= n; ++p) {
+            if (p == player) continue;
+            best_opponent_max = std::max(best_opponent_max, board.player_max_values[p]);
+            opponent_cells += popcount(board.occupancy[p]);
+            opponent_mobility += count_mobility(board, p);
+        }
+        
+        int max_diff = board.player_max_values[player] - best_opponent_max;
+        int cell_diff = popcount(board.occupancy[player]) - opponent_cells / (n - 1);
+        int mobility_diff = count_mobility(board, player) - opponent_mobility / (n - 1);
+        
+        return max_diff * params.max_value_weight + cell_diff * params.cell_weight +
+               mobility_diff * params.mobility_weight;
+    }
+    
+    // Empty cells the player reaches before the opponent (king steps through
+    // empty cells, ties neutral) minus those the opponent reaches first. Not
+    // part of evaluate(); evaluate_batch reports it alongside the other terms.
+    static int territory_diff(const BoardState& board, int player) {
+        const BoardMasks& masks = board_masks(board.size);
+        int opponent = (player == PLAYER_A) ? PLAYER_B : PLAYER_A;
+        Bitboard free = masks.full & ~board.occupancy[0];
+        Bitboard own_front = board.occupancy[player], other_front = board.occupancy[opponent];
+        int diff = 0;
+        while (own_front | other_front) {
+            own_front = dilate(own_front, masks) & free;
+            other_front = dilate(other_front, masks) & free;
+            diff += popcount(own_front & ~other_front) - popcount(other_front & ~own_front);
+            free &= ~(own_front | other_front);
+        }
+        return diff;
+    }
+    
+    // True if no player has a legal move
+    bool is_game_over(const BoardState& board) const {
+        const BoardMasks& masks = board_masks(board.size);
+        Bitboard all_players = 0;
+        for (int p = 1; p <= board.num_players; ++p) {
+            all_players |= board.occupancy[p];
+        }
+        return (dilate(all_players, masks) & ~board.occupancy[0]) == 0;
+    }
+    
+    // Move ordering for better pruning (Stockfish-inspired)
+    void order_moves(std::vector<Move>& moves, const BoardState& board, int player,
+                     const Move& hash_move = Move()) const {
+        bool learned = ordering.has(board.size);
+        int phase = learned ? game_phase(board) : 0;
+        
+        for (auto& move : moves) {
+            // Higher value moves first
+            move.score = move.value * MoveOrderingTables::SCALE;
+            
+            if (learned) {
+                // Learned cutoff rate for this phase, cell and value delta
+                move.score += ordering.prior(board.size, MoveOrderingTables::index(
+                    phase, move.row * MAX_BOARD_SIZE + move.col,
+                    move.value - board.player_max_values[player]));
+            } else {
+                // Center control bonus
+                int center = board.size / 2;
+                int dist = std::abs(move.row - center) + std::abs(move.col - center);
+                move.score += (board.size - dist) * params.center_weight;
+            }
+            
+            // Best move from the transposition table goes first
+            if (move.row == hash_move.row && move.col == hash_move.col &&
+                move.value == hash_move.value) {
+                move.score += 1 << 24;
+            }
+        }
+        
+        std::sort(moves.begin(), moves.end(), 
+                 [](const Move& a, const Move& b) { return a.score > b.score; });
+    }
+    
+    // Transposition key: the side to move and the root player matter, since
+    // scores are from the root player's point of view
+    static uint64_t search_key(const BoardState& board, int to_move, int root) {
+        return board.hash() ^ (static_cast<uint64_t>(to_move) * 0x9E3779B97F4A7C15ULL)
+                            ^ (static_cast<uint64_t>(root) * 0xC2B2AE3D27D4EB4FULL);
+    }
+    
+    // Exact key of the node in verified mode, or null to use the hashed tt
+    const ExactKey* verified_key(const BoardState& board, int to_move, int root,
+                                 ExactKey& key) const {
+        return verified_tt && ExactKey::make(board, to_move, root, key) ? &key : nullptr;
+    }
+    
+    bool probe_tt(SearchContext& ctx, uint64_t hash, const ExactKey* exact, int depth,
+                  int alpha, int beta, int& score, Move& move) const {
+        bool hit = exact ? verified_tt->probe(hash, *exact, depth, alpha, beta, score, move)
+                         : tt.probe(hash, depth, alpha, beta, score, move);
+        ctx.tt_probes++;
+        ctx.tt_hits += hit;
+        return hit;
+    }
+    
+    void store_tt(SearchContext& ctx, uint64_t hash, const ExactKey* exact, int depth,
+                  int score, int flag, const Move& move) {
+        bool replaced = exact ? verified_tt->store(hash, *exact, depth, score, flag, move)
+                              : tt.store(hash, depth, score, flag, move);
+        ctx.tt_stores++;
+        ctx.tt_overwrites += replaced;
+    }
+    
+    // Count a node against the context's limits; false means stop searching
+    static bool enter_node(SearchContext& ctx) {
+        if (ctx.stop->load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if (ctx.node_budget &&
+            ctx.shared_nodes->fetch_add(1, std::memory_order_relaxed) >= ctx.node_budget) {
+            ctx.stop->store(true, std::memory_order_relaxed);
+            return false;
+        }
+        // The clock is read every 1024 nodes
+        if (ctx.timed && (ctx.nodes & 1023) == 0 &&
+            std::chrono::steady_clock::now() >= ctx.deadline) {
+            ctx.stop->store(true, std::memory_order_relaxed);
+            return false;
+        }
+        ctx.nodes++;
+        return true;
+    }
+    
+    // Minimax with alpha-beta pruning. The root player maximizes its own
+    // evaluation and every other player minimizes it, which with more than
+    // two players is paranoid search. Returns 0 once ctx is stopped; such
+    // results are never stored.
+    int minimax(SearchContext& ctx, BoardState& board, int depth, int alpha, int beta,
+                int to_move, int root, Move& best_move) {
+        if (!enter_node(ctx)) {
+            return 0;
+        }
+        
+        // Check transposition table
+        uint64_t hash = search_key(board, to_move, root);
+        ExactKey exact_key;
+        const ExactKey* exact = verified_key(board, to_move, root, exact_key);
+        Move tt_move;
+        int tt_score;
+        if (probe_tt(ctx, hash, exact, depth, alpha, beta, tt_score, tt_move)) {
+            best_move = tt_move;
+            return tt_score;
+        }
+        
+        // Terminal condition
+        if (depth == 0) {
+            int flag;
+            int score = evaluate_lazy(board, root, alpha, beta, flag);
+            store_tt(ctx, hash, exact, depth, score, flag, best_move);
+            return score;
+        }
+        
+        int next = next_player(to_move, board.num_players);
+        auto moves = generate_moves(board, to_move);
+        
+        // Check if game is over
+        if (moves.empty()) {
+            if (is_game_over(board)) {
+                int flag;
+                int score = evaluate_lazy(board, root, alpha, beta, flag);
+                store_tt(ctx, hash, exact, depth, score, flag, best_move);
+                return score;
+            }
+            // Current player has no moves, switch
+            return minimax(ctx, board, depth - 1, alpha, beta, next, root, best_move);
+        }
+        
+        // Move ordering
+        order_moves(moves, board, to_move, tt_move);
+        
+        bool maximizing = (to_move == root);
+        int alpha_orig = alpha, beta_orig = beta;
+        int best_eval = maximizing ? std::numeric_limits<int>::min()
+                                   : std::numeric_limits<int>::max();
+        Move local_best;
+        int phase = ctx.cutoff_stats ? game_phase(board) : 0;
+        size_t searched = 0;
+        
+        for (const auto& move : moves) {
+            make_move(board, move, to_move);
+            Move dummy;
+            int eval = minimax(ctx, board, depth - 1, alpha, beta, next, root, dummy);
+            unmake_move(board, move, to_move);
+            
+            if (ctx.stop->load(std::memory_order_relaxed)) {
+                return 0;
+            }
+            
+            searched++;
+            int stats_index = 0;
+            if (ctx.cutoff_stats) {
+                stats_index = board.size * MoveOrderingTables::ENTRIES + MoveOrderingTables::index(
+                    phase, move.row * MAX_BOARD_SIZE + move.col,
+                    move.value - board.player_max_values[to_move]);
+                ctx.cutoff_stats->tried[stats_index] += depth * depth;
+            }
+            
+            if (maximizing ? eval > best_eval : eval < best_eval) {
+                best_eval = eval;
+                local_best = move;
+            }
+            if (maximizing) {
+                alpha = std::max(alpha, eval);
+            } else {
+                beta = std::min(beta, eval);
+            }
+            if (beta <= alpha) {
+                if (ctx.cutoff_stats) {
+                    ctx.cutoff_stats->cutoffs[stats_index] += depth * depth;
+                    ctx.cutoff_stats->cutoff_nodes++;
+                    ctx.cutoff_stats->first_move_cutoffs += (searched == 1);
+                }
+                break;  // Cutoff
+            }
+        }
+        
+        int flag = 0;
+        if (best_eval >= beta_orig) {
+            flag = 1;
+        } else if (best_eval <= alpha_orig) {
+            flag = 2;
+        }
+        best_move = local_best;
+        store_tt(ctx, hash, exact, depth, best_eval, flag, best_move);
+        return best_eval;
+    }
+    
+    // MTD(f): converge on the minimax value at depth through zero-window
+    // searches starting from guess. Each one fails high (raising the lower
+    // bound) or low (lowering the upper bound) until the bounds meet; the
+    // bounds the table keeps make the repeated searches cheap. best_move is
+    // from the last search that failed high, which proved the value.
+    int mtdf(SearchContext& ctx, BoardState& board, int depth, int guess, int player,
+             Move& best_move) {
+        int lower = std::numeric_limits<int>::min(), upper = std::numeric_limits<int>::max();
+        int g = guess;
+        Move pass_best;
+        while (lower < upper) {
+            int beta = (g == lower) ? g + 1 : g;
+            pass_best = Move();
+            g = minimax(ctx, board, depth, beta - 1, beta, player, player, pass_best);
+            ctx.passes++;
+            if (ctx.stop->load(std::memory_order_relaxed)) {
+                return g;
+            }
+            if (g < beta) {
+                upper = g;
+            } else {
+                lower = g;
+                best_move = pass_best;
+            }
+        }
+        if (best_move.value == 0) {
+            best_move = pass_best;
+        }
+        return g;
+    }
+    
+    // Iterative deepening from start_depth to max_depth. Returns the best
+    // move of the last iteration that completed before ctx was stopped.
+    // Each iteration is one full-window alpha-beta search, or with the MTD(f)
+    // driver a series of zero-window searches. These are seeded by the value
+    // two iterations back: odd and even depths end on different players'
+    // moves, and the previous depth's value is usually the worse guess.
+    Move iterative_deepening(SearchContext& ctx, BoardState& board, int player,
+                             int start_depth, int max_depth) {
+        Move best_move;
+        int guess[2];
+        guess[0] = guess[1] = evaluate_multi(board, player);
+        for (int depth = start_depth; depth <= max_depth; ++depth) {
+            Move iteration_best;
+            if (mtdf_driver) {
+                guess[depth & 1] = mtdf(ctx, board, depth, guess[depth & 1], player, iteration_best);
+            } else {
+                minimax(ctx, board, depth,
+                        std::numeric_limits<int>::min(),
+                        std::numeric_limits<int>::max(),
+                        player, player, iteration_best);
+            }
+            if (ctx.stop->load(std::memory_order_relaxed)) {
+                break;
+            }
+            best_move = iteration_best;
+            ctx.completed_depth = depth;
+        }
+        return best_move;
+    }
+    
+    // Deepest iteration worth searching. Each empty cell takes one move,
+    // and before it at most num_players - 1 players can pass (one more and
+    // the game is over), so no line is longer than num_players plies per
+    // empty cell.
+    static int depth_cap(const BoardState& board, int max_depth) {
+        int empty = popcount(board_masks(board.size).full & ~board.occupancy[0]);
+        return std::max(1, std::min(max_depth, board.num_players * empty + 1));
+    }
+    
+    // Best statically ordered move, used when no iteration completed
+    Move first_ordered_move(const BoardState& board, int player) const {
+        auto moves = generate_moves(board, player);
+        order_moves(moves, board, player);
+        return moves.empty() ? Move() : moves[0];
+    }
+    
+    void start_resumable(ResumableSearch& s, const BoardState& board, int player,
+                         int max_depth, uint64_t node_budget) const {
+        s.board.copy_from(board);
+        s.player = player;
+        s.depth = 1;
+        s.max_depth = depth_cap(board, max_depth);
+        s.nodes = 0;
+        s.node_budget = node_budget;
+        s.stack.clear();
+        s.best_move = first_ordered_move(board, player);
+        s.completed_depth = 0;
+        s.finished = false;
+    }
+    
+    // Entry half of minimax() for the resumable search: returns true with
+    // the node's value if it needs no children, otherwise pushes a frame
+    bool enter_frame(ResumableSearch& s, int depth, int alpha, int beta, int to_move,
+                     int& value, Move& node_move) {
+        s.nodes++;
+        BoardState& board = s.board;
+        
+        uint64_t hash = search_key(board, to_move, s.player);
+        Move tt_move;
+        if (tt.probe(hash, depth, alpha, beta, value, tt_move)) {
+            node_move = tt_move;
+            return true;
+        }
+        if (depth == 0) {
+            int flag;
+            value = evaluate_lazy(board, s.player, alpha, beta, flag);
+            tt.store(hash, depth, value, flag, Move());
+            return true;
+        }
+        
+        auto moves = generate_moves(board, to_move);
+        if (moves.empty()) {
+            if (is_game_over(board)) {
+                int flag;
+                value = evaluate_lazy(board, s.player, alpha, beta, flag);
+                tt.store(hash, depth, value, flag, Move());
+                return true;
+            }
+            s.stack.push_back({depth, alpha, beta, to_move, alpha, beta, 0, hash, true, {}, 0, Move()});
+            return false;
+        }
+        
+        order_moves(moves, board, to_move, tt_move);
+        int best_eval = to_move == s.player ? std::numeric_limits<int>::min()
+                                            : std::numeric_limits<int>::max();
+        s.stack.push_back({depth, alpha, beta, to_move, alpha, beta, best_eval, hash, false,
+                           std::move(moves), 0, Move()});
+        return false;
+    }
+    
+    // Run the resumable search for up to quota nodes. Returns true once it
+    // has finished (all iterations done or node budget spent).
+    bool resume(ResumableSearch& s, uint64_t quota) {
+        uint64_t start_nodes = s.nodes;
+        bool has_result = false;  // a child value is waiting for the top frame
+        int result = 0;
+        
+        while (!s.finished) {
+            if (s.stack.empty() && !has_result && s.depth > s.max_depth) {
+                s.finished = true;
+                break;
+            }
+            
+            if (has_result) {
+                has_result = false;
+                if (s.stack.empty()) {
+                    // Root answered from the table or as a leaf
+                    s.completed_depth = s.depth++;
+                    continue;
+                }
+                ResumableSearch::Frame& f = s.stack.back();
+                if (f.pass) {
+                    // Blocked player: pass the child's value straight up
+                    s.stack.pop_back();
+                    if (s.stack.empty()) {
+                        s.completed_depth = s.depth++;
+                    } else {
+                        has_result = true;
+                    }
+                    continue;
+                }
+                const Move& move = f.moves[f.next_index - 1];
+                unmake_move(s.board, move, f.to_move);
+                bool maximizing = f.to_move == s.player;
+                if (maximizing ? result > f.best_eval : result < f.best_eval) {
+                    f.best_eval = result;
+                    f.local_best = move;
+                }
+                if (maximizing) {
+                    f.alpha = std::max(f.alpha, result);
+                } else {
+                    f.beta = std::min(f.beta, result);
+                }
+                if (f.beta <= f.alpha) {
+                    f.next_index = f.moves.size();  // Cutoff
+                }
+            }
+            
+            // Suspend only between nodes, when no child value is pending
+            bool entering = s.stack.empty() ||
+                (s.stack.back().pass ? s.stack.back().next_index == 0
+                                     : s.stack.back().next_index < s.stack.back().moves.size());
+            if (entering) {
+                if (s.node_budget && s.nodes >= s.node_budget) {
+                    s.finished = true;
+                    break;
+                }
+                if (s.nodes - start_nodes >= quota) {
+                    return false;
+                }
+            }
+            
+            Move node_move;
+            if (s.stack.empty()) {
+                // Start the next iteration at the root
+                if (enter_frame(s, s.depth, std::numeric_limits<int>::min(),
+                                std::numeric_limits<int>::max(), s.player, result, node_move)) {
+                    if (node_move.value > 0) s.best_move = node_move;
+                    has_result = true;
+                }
+                continue;
+            }
+            
+            ResumableSearch::Frame& f = s.stack.back();
+            int next = next_player(f.to_move, s.board.num_players);
+            if (f.pass) {
+                f.next_index = 1;
+                int depth = f.depth - 1, alpha = f.alpha, beta = f.beta;
+                has_result = enter_frame(s, depth, alpha, beta, next, result, node_move);
+                continue;
+            }
+            if (f.next_index < f.moves.size()) {
+                const Move move = f.moves[f.next_index++];
+                make_move(s.board, move, f.to_move);
+                int depth = f.depth - 1, alpha = f.alpha, beta = f.beta;
+                has_result = enter_frame(s, depth, alpha, beta, next, result, node_move);
+                continue;
+            }
+            
+            // All children searched: finish the node
+            int flag = 0;
+            if (f.best_eval >= f.beta_orig) {
+                flag = 1;
+            } else if (f.best_eval <= f.alpha_orig) {
+                flag = 2;
+            }
+            tt.store(f.hash, f.depth, f.best_eval, flag, f.local_best);
+            result = f.best_eval;
+            Move node_best = f.local_best;
+            s.stack.pop_back();
+            if (s.stack.empty()) {
+                s.best_move = node_best;
+                s.completed_depth = s.depth++;
+            } else {
+                has_result = true;
+            }
+        }
+        return true;
+    }
+    
+    // Search with helper threads (Lazy SMP): helpers run the same iterative
+    // deepening on their own board copies, sharing the transposition table
+    // and the node budget, and the main thread's result is returned.
+    // A node-limited search starts from an empty table, so its result depends
+    // only on the position and not on earlier searches.
+    // Returns the number of nodes searched by all threads.
+    uint64_t parallel_search(BoardState& board, int player, int max_depth,
+                             uint64_t node_budget, int threads, Move& best_move,
+                             double time_ms = 0.0) {
+        std::atomic<uint64_t> shared_nodes(0);
+        std::atomic<bool> stop(false);
+        
+        if (node_budget) {
+            clear_tt();
+        }
+        max_depth = depth_cap(board, max_depth);
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::microseconds(static_cast<int64_t>(time_ms * 1000));
+        
+        std::vector<SearchContext> contexts(std::max(threads, 1));
+        for (auto& ctx : contexts) {
+            ctx.node_budget = node_budget;
+            ctx.shared_nodes = &shared_nodes;
+            ctx.stop = &stop;
+            ctx.timed = time_ms > 0.0;
+            ctx.deadline = deadline;
+        }
+        
+        cpu_set_t caller_cpus;
+        bool pinned = pin_threads &&
+                      sched_getaffinity(0, sizeof(caller_cpus), &caller_cpus) == 0 &&
+                      pin_to_node(0);
+        
+        std::vector<std::thread> helpers;
+        for (size_t i = 1; i < contexts.size(); ++i) {
+            helpers.emplace_back([this, &contexts, &board, player, max_depth, i] {
+                if (pin_threads) {
+                    pin_to_node(i);
+                }
+                BoardState local;
+                local.copy_from(board);
+                // Odd helpers skip a depth so threads desynchronise
+                iterative_deepening(contexts[i], local, player, 1 + (i & 1), max_depth);
+            });
+        }
+        
+        contexts[0].cutoff_stats = cutoff_stats.get();
+        best_move = iterative_deepening(contexts[0], board, player, 1, max_depth);
+        if (contexts[0].completed_depth == 0) {
+            // Not even depth 1 finished within the budget
+            best_move = first_ordered_move(board, player);
+        }
+        stop.store(true, std::memory_order_relaxed);
+        for (auto& helper : helpers) {
+            helper.join();
+        }
+        if (pinned) {
+            sched_setaffinity(0, sizeof(caller_cpus), &caller_cpus);
+        }
+        
+        last_search = SearchStats();
+        last_search.threads = static_cast<int>(contexts.size());
+        last_search.completed_depth = contexts[0].completed_depth;
+        last_search.main_nodes = contexts[0].nodes;
+        for (const auto& ctx : contexts) {
+            last_search.nodes += ctx.nodes;
+            last_search.tt_probes += ctx.tt_probes;
+            last_search.tt_hits += ctx.tt_hits;
+            last_search.tt_stores += ctx.tt_stores;
+            last_search.tt_overwrites += ctx.tt_overwrites;
+            last_search.passes += ctx.passes;
+        }
+        return last_search.nodes;
+    }
+    
+    using ScoreVector = std::array<int, MAX_PLAYERS + 1>;
+    
+    // Max^n for N players: each player maximizes its own component of the
+    // evaluation vector (no pruning, no transposition table)
+    void maxn(BoardState& board, int depth, int to_move, ScoreVector& scores, Move& best_move) {
+        nodes_evaluated++;
+        
+        if (depth == 0 || is_game_over(board)) {
+            for (int p = 1; p <= board.num_players; ++p) {
+                scores[p] = evaluate_multi(board, p);
+            }
+            return;
+        }
+        
+        int next = next_player(to_move, board.num_players);
+        auto moves = generate_moves(board, to_move);
+        
+        if (moves.empty()) {
+            Move dummy;
+            maxn(board, depth - 1, next, scores, dummy);
+            return;
+        }
+        
+        order_moves(moves, board, to_move);
+        
+        bool first = true;
+        for (const auto& move : moves) {
+            make_move(board, move, to_move);
+            ScoreVector child;
+            Move dummy;
+            maxn(board, depth - 1, next, child, dummy);
+            unmake_move(board, move, to_move);
+            
+            if (first || child[to_move] > scores[to_move]) {
+                scores = child;
+                best_move = move;
+                first = false;
+            }
+        }
+    }
+    
+    // Best move recorded in the experience book, if its outcome has been
+    // seen in enough games and it is legal here
+    bool probe_book(const BoardState& board, int player, Move& move) {
+        // Book keys are 64-bit hashes, so verified searches do not trust them
+        if (verified_tt && board.size <= ExactKey::MAX_SIZE) {
+            return false;
+        }
+        const ExperienceBook::Entry* entry = book.lookup(position_key(board, player));
+        if (!entry || !entry->best_child) {
+            return false;
+        }
+        const ExperienceBook::Entry* child = book.lookup(entry->best_child);
+        if (!child || child->visits < static_cast<uint32_t>(book_min_visits)) {
+            return false;
+        }
+        Move candidate = unpack_move(entry->best_move);
+        for (const auto& legal : generate_moves(board, player)) {
+            if (legal.row == candidate.row && legal.col == candidate.col &&
+                legal.value == candidate.value) {
+                move = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Convert Python board (rows of None or (player_id, value)) to internal representation
+    static BoardState load_board(py::list board_2d, int board_size, int num_players) {
+        if (board_size < 1 || board_size > MAX_BOARD_SIZE) {
+            throw std::invalid_argument("board_size must be between 1 and " +
+                                        std::to_string(MAX_BOARD_SIZE));
+        }
+        if (num_players < 2 || num_players > MAX_PLAYERS) {
+            throw std::invalid_argument("num_players must be between 2 and " +
+                                        std::to_string(MAX_PLAYERS));
+        }
+        
+        BoardState board(board_size, num_players);
+        
+        for (int i = 0; i < board_size; ++i) {
+            py::list row = board_2d[i];
+            for (int j = 0; j < board_size; ++j) {
+                py::object cell = row[j];
+                
+                if (!cell.is_none()) {
+                    py::tuple cell_tuple = cell.cast<py::tuple>();
+                    int player_id = cell_tuple[0].cast<int>();
+                    int value = cell_tuple[1].cast<int>();
+                    if (player_id < 1 || player_id > num_players) {
+                        throw std::invalid_argument("cell owner out of range: " +
+                                                    std::to_string(player_id));
+                    }
+                    board.set_cell(i, j, player_id, value);
+                }
+            }
+        }
+        return board;
+    }
+    
+public:
+    SearchEngine(size_t tt_size = 1048576, double tt_fraction = 0.0)
+        : tt(MIN_TT_ENTRIES), nodes_evaluated(0), tt_memory_fraction(tt_fraction),
+          last_memory_check(std::chrono::steady_clock::now()) {
+        if (tt_memory_fraction < 0.0 || tt_memory_fraction > 1.0) {
+            throw std::invalid_argument("tt_memory_fraction must be between 0 and 1");
+        }
+        size_t entries = tt_memory_fraction > 0.0 ? auto_tt_entries() : 0;
+        tt.resize(entries ? entries : std::max(tt_size, MIN_TT_ENTRIES));
+    }
+    
+    // In auto-size mode, shrink the TT (rehashing its entries) if memory
+    // pressure has risen since it was sized. Checked at most once a second.
+    void check_memory_pressure(bool force = false) {
+        if (tt_memory_fraction <= 0.0) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (!force && now - last_memory_check < std::chrono::seconds(1)) {
+            return;
+        }
+        last_memory_check = now;
+        
+        size_t target = auto_tt_entries();
+        // Shrink by at least a quarter to avoid rehashing on small fluctuations
+        if (target && target < tt.size() - tt.size() / 4) {
+            tt.rehash(target);
+        }
+    }
+    
+    // Python interface: find best move.
+    // nodes > 0 stops the search after exactly that many nodes and returns the
+    // best move of the last completed iteration. Such a search starts from an
+    // empty table and runs on one thread, so the result is independent of
+    // hardware, load and earlier calls.
+    py::tuple find_best_move(py::list board_2d, int board_size, int player, int depth,
+                             uint64_t nodes, int threads) {
+        check_threads(threads, nodes);
+        nodes_evaluated = 0;
+        check_memory_pressure();
+        
+        BoardState board = load_board(board_2d, board_size, 2);
+        if (request_log.is_open()) {
+            request_log.record(board, player, depth, nodes, threads, RequestLog::TWO_PLAYER);
+        }
+        
+        // Experience book first: a hit costs no search at all
+        Move best_move;
+        if (probe_book(board, player, best_move)) {
+            book_hits++;
+            return py::make_tuple(best_move.row, best_move.col, best_move.value, nodes_evaluated);
+        }
+        
+        // Run search
+        {
+            py::gil_scoped_release release;
+            nodes_evaluated = parallel_search(board, player, depth, nodes, threads, best_move);
+        }
+        
+        // Return (row, col, value, nodes_evaluated)
+        return py::make_tuple(best_move.row, best_move.col, best_move.value, nodes_evaluated);
+    }
+    
+    // Threads for one search. Helpers race on the shared table, so a
+    // node-limited search, whose result must be reproducible, runs on one.
+    static void check_threads(int threads, uint64_t nodes) {
+        if (threads < 1 || threads > MAX_SEARCH_THREADS) {
+            throw std::invalid_argument("threads must be between 1 and " +
+                                        std::to_string(MAX_SEARCH_THREADS));
+        }
+        if (nodes && threads > 1) {
+            throw std::invalid_argument("a node-limited search runs on one thread");
+        }
+    }
+    
+    // Python interface: find best move for one of 2-4 players.
+    // mode is "paranoid" (alpha-beta against a minimizing coalition) or "maxn".
+    py::tuple find_best_move_multi(py::list board_2d, int board_size, int player, int depth,
+                                   int num_players, const std::string& mode) {
+        nodes_evaluated = 0;
+        check_memory_pressure();
+        
+        BoardState board = load_board(board_2d, board_size, num_players);
+        if (player < 1 || player > num_players) {
+            throw std::invalid_argument("player out of range: " + std::to_string(player));
+        }
+        if (mode != "paranoid" && mode != "maxn") {
+            throw std::invalid_argument("unknown search mode: " + mode);
+        }
+        if (request_log.is_open()) {
+            request_log.record(board, player, depth, 0, 1,
+                               mode == "maxn" ? RequestLog::MAXN : RequestLog::PARANOID);
+        }
+        
+        Move best_move;
+        if (mode == "paranoid") {
+            nodes_evaluated = parallel_search(board, player, depth, 0, 1, best_move);
+        } else {
+            ScoreVector scores{};
+            maxn(board, depth, player, scores, best_move);
+        }
+        
+        return py::make_tuple(best_move.row, best_move.col, best_move.value, nodes_evaluated);
+    }
+    
+    // Append every following search request to a binary log (see RequestLog)
+    void start_recording(const std::string& path) {
+        request_log.open(path);
+    }
+    
+    void stop_recording() {
+        request_log.close();
+    }
+    
+    // Re-run a recorded request the way the original call would have
+    // (without the experience book); returns the move found
+    Move replay_request(const RequestLog::Request& request) {
+        const RequestLog::Header& header = request.header;
+        BoardState board = request.board;
+        Move best_move;
+        if (header.mode == RequestLog::MAXN) {
+            ScoreVector scores{};
+            nodes_evaluated = 0;
+            maxn(board, header.depth, header.player, scores, best_move);
+        } else {
+            nodes_evaluated = parallel_search(board, header.player, header.depth,
+                                              header.nodes, header.threads, best_move);
+        }
+        return best_move;
+    }
+    
+    void clear_tt() {
+        tt.clear();
+        if (verified_tt) {
+            verified_tt->clear();
+        }
+    }
+    
+    // Verified mode: boards up to 6x6 use exact position keys in a table of
+    // the given number of entries, so no result is ever taken from another
+    // position. Larger boards keep using the hashed table.
+    void set_verified(bool enable, size_t entries) {
+        if (enable && entries == 0) {
+            throw std::invalid_argument("verified table needs at least one entry");
+        }
+        verified_tt.reset(enable ? new VerifiedTable(entries) : nullptr);
+    }
+    
+    bool is_verified() const {
+        return verified_tt != nullptr;
+    }
+    
+    // Lazy leaf evaluation returns bounds, so the table stays valid either way
+    void set_lazy_eval(bool enable) {
+        lazy_eval = enable;
+    }
+    
+    bool is_lazy_eval() const {
+        return lazy_eval;
+    }
+    
+    void set_root_driver(const std::string& driver) {
+        if (driver != "alphabeta" && driver != "mtdf") {
+            throw std::invalid_argument("driver must be 'alphabeta' or 'mtdf'");
+        }
+        mtdf_driver = driver == "mtdf";
+    }
+    
+    std::string get_root_driver() const {
+        return mtdf_driver ? "mtdf" : "alphabeta";
+    }
+    
+    void load_params(const std::string& path) {
+        params.load(path);
+        clear_tt();
+    }
+    
+    void save_params(const std::string& path) const {
+        params.save(path);
+    }
+    
+    void set_params(const std::map<std::string, int>& values) {
+        params.set(values);
+        clear_tt();
+    }
+    
+    std::map<std::string, int> get_params() const {
+        return params.values();
+    }
+    
+    uint64_t get_nodes_evaluated() const {
+        return nodes_evaluated;
+    }
+    
+    size_t get_tt_size() const {
+        return tt.size();
+    }
+    
+    // Resize the table keeping its entries, as the auto-size mode does under
+    // memory pressure (a shrink needs no memory beyond the current table)
+    void rehash_tt(size_t entries) {
+        tt.rehash(std::max(entries, MIN_TT_ENTRIES));
+    }
+    
+    // NUMA placement: "interleave" spreads the transposition table's pages
+    // over all nodes, "local" leaves them where they are first touched (the
+    // table is emptied either way); pin binds search threads to nodes
+    // round-robin
+    void set_numa_policy(const std::string& placement, bool pin) {
+        if (placement != "local" && placement != "interleave") {
+            throw std::invalid_argument("placement must be 'local' or 'interleave'");
+        }
+        tt.set_interleave(placement == "interleave");
+        pin_threads = pin;
+    }
+    
+    py::dict get_numa_policy() const {
+        py::dict policy;
+        policy["nodes"] = numa_node_cpus().size();
+        policy["interleaved"] = tt.is_interleaved();
+        policy["pin_threads"] = pin_threads;
+        return policy;
+    }
+    
+    // Thread and transposition-table counters of the last alpha-beta search
+    py::dict get_search_stats() const {
+        py::dict stats;
+        stats["threads"] = last_search.threads;
+        stats["completed_depth"] = last_search.completed_depth;
+        stats["nodes"] = last_search.nodes;
+        stats["main_nodes"] = last_search.main_nodes;
+        stats["tt_probes"] = last_search.tt_probes;
+        stats["tt_hits"] = last_search.tt_hits;
+        stats["tt_stores"] = last_search.tt_stores;
+        stats["tt_overwrites"] = last_search.tt_overwrites;
+        stats["passes"] = last_search.passes;
+        return stats;
+    }
+    
+    static constexpr int EVAL_TERMS = 5;
+    
+    // Static evaluation of many two-player positions (python interface).
+    // boards holds (n, 2, size, size) owner (0 empty, 1 A, 2 B) and value
+    // planes, players the side each is scored for. Returns an (n, EVAL_TERMS)
+    // array: max value, cell, mobility and territory differences, then the
+    // weighted evaluate() score. Positions are split over up to threads
+    // workers (0 = one per core), with at least 1024 positions each; a
+    // single worker runs on the calling thread.
+    py::array_t<int32_t> evaluate_batch(
+            py::array_t<int32_t, py::array::c_style | py::array::forcecast> boards,
+            py::array_t<int32_t, py::array::c_style | py::array::forcecast> players, int threads) {
+        if (boards.ndim() != 4 || boards.shape(1) != 2 || boards.shape(2) != boards.shape(3)) {
+            throw std::invalid_argument("boards must have shape (n, 2, size, size)");
+        }
+        ssize_t n = boards.shape(0);
+        int size = static_cast<int>(boards.shape(2));
+        if (size < 2 || size > MAX_BOARD_SIZE) {
+            throw std::invalid_argument("board size must be between 2 and " +
+                                        std::to_string(MAX_BOARD_SIZE));
+        }
+        if (players.ndim() != 1 || players.shape(0) != n) {
+            throw std::invalid_argument("players must have shape (n,)");
+        }
+        const int32_t* planes = boards.data();
+        const int32_t* sides = players.data();
+        for (ssize_t i = 0; i < n; ++i) {
+            if (sides[i] != PLAYER_A && sides[i] != PLAYER_B) {
+                throw std::invalid_argument("players must be 1 or 2");
+            }
+        }
+        
+        py::array_t<int32_t> terms({n, static_cast<ssize_t>(EVAL_TERMS)});
+        int32_t* out = terms.mutable_data();
+        std::atomic<bool> bad_owner(false), bad_value(false);
+        {
+            py::gil_scoped_release release;
+            int cells = size * size;
+            auto evaluate_one = [&](size_t i) {
+                const int32_t* owner = planes + i * 2 * cells;
+                const int32_t* value = owner + cells;
+                BoardState board(size);
+                for (int c = 0; c < cells; ++c) {
+                    if (owner[c] == 0) continue;
+                    if (owner[c] != PLAYER_A && owner[c] != PLAYER_B) {
+                        bad_owner = true;
+                        return;
+                    }
+                    if (value[c] < 1 || value[c] > 99) {
+                        bad_value = true;
+                        return;
+                    }
+                    board.set_cell(c / size, c % size, owner[c], value[c]);
+                }
+                int player = sides[i], opponent = 3 - player;
+                int32_t* row = out + i * EVAL_TERMS;
+                row[0] = board.player_max_values[player] - board.player_max_values[opponent];
+                row[1] = popcount(board.occupancy[player]) - popcount(board.occupancy[opponent]);
+                row[2] = count_mobility(board, player) - count_mobility(board, opponent);
+                row[3] = territory_diff(board, player);
+                row[4] = evaluate(board, player);
+            };
+            int workers = static_cast<int>(std::min<ssize_t>(
+                threads > 0 ? threads : std::thread::hardware_concurrency(),
+                std::max<ssize_t>(1, n / 1024)));
+            if (workers <= 1) {
+                for (ssize_t i = 0; i < n; ++i) {
+                    evaluate_one(i);
+                }
+            } else {
+                if (!batch_pool || batch_pool->size() != workers) {
+                    batch_pool.reset(new WorkerPool(workers));
+                }
+                batch_pool->parallel_for(n, evaluate_one);
+            }
+        }
+        if (bad_owner) {
+            throw std::invalid_argument("owners must be 0, 1 or 2");
+        }
+        if (bad_value) {
+            throw std::invalid_argument("owned cells must have values between 1 and 99");
+        }
+        return terms;
+    }
+    
+    // Start (or stop) gathering cutoff statistics for learned move ordering
+    void collect_cutoff_stats(bool enable) {
+        if (enable && !cutoff_stats) {
+            cutoff_stats.reset(new MoveOrderingTables::Stats());
+        } else if (!enable) {
+            cutoff_stats.reset();
+        }
+    }
+    
+    // (nodes ending in a cutoff, of which the first move cut) since collection began
+    py::tuple get_cutoff_stats() const {
+        if (!cutoff_stats) {
+            return py::make_tuple(0, 0);
+        }
+        return py::make_tuple(cutoff_stats->cutoff_nodes, cutoff_stats->first_move_cutoffs);
+    }
+    
+    // Turn the collected statistics into ordering tables and write them
+    void save_ordering_tables(const std::string& path) {
+        if (!cutoff_stats) {
+            throw std::runtime_error("no cutoff statistics collected");
+        }
+        MoveOrderingTables tables;
+        tables.build(*cutoff_stats);
+        tables.save(path);
+    }
+    
+    void load_ordering_tables(const std::string& path) {
+        ordering.load(path);
+    }
+    
+    // Open (or create) a memory-mapped experience book at path. Moves are
+    // played from the book once their outcome has min_visits games behind it.
+    void open_experience_book(const std::string& path, int min_visits, uint64_t capacity) {
+        book.open(path, capacity);
+        book_min_visits = min_visits;
+        book_hits = 0;
+        book.merge_log();
+    }
+    
+    // Append a finished two-player game, given as (player, row, col, value)
+    // moves from the standard start position, to the book's log and
+    // optionally merge it into the book right away
+    void record_game(int board_size, const std::vector<std::array<int, 4>>& moves, bool merge) {
+        if (!book.is_open()) {
+            throw std::runtime_error("no experience book is open");
+        }
+        if (board_size < 2 || board_size > MAX_BOARD_SIZE) {
+            throw std::invalid_argument("board_size must be between 2 and " +
+                                        std::to_string(MAX_BOARD_SIZE));
+        }
+        
+        BoardState board(board_size);
+        board.set_cell(0, 0, PLAYER_A, 1);
+        board.set_cell(board_size - 1, board_size - 1, PLAYER_B, 1);
+        
+        std::vector<uint64_t> keys;
+        for (const auto& m : moves) {
+            if (m[0] < PLAYER_A || m[0] > PLAYER_B || m[1] < 0 || m[1] >= board_size ||
+                m[2] < 0 || m[2] >= board_size || m[3] < 1 || m[3] > 99 ||
+                board.board[m[1]][m[2]] != 0) {
+                throw std::invalid_argument("illegal move in recorded game");
+            }
+            keys.push_back(position_key(board, m[0]));
+            board.set_cell(m[1], m[2], m[0], m[3]);
+        }
+        
+        int max_a = board.player_max_values[PLAYER_A];
+        int max_b = board.player_max_values[PLAYER_B];
+        int outcome_a = (max_a > max_b) - (max_a < max_b);
+        
+        std::vector<ExperienceBook::LogRecord> records;
+        for (size_t i = 0; i < moves.size(); ++i) {
+            int mover = moves[i][0];
+            uint64_t child_key = i + 1 < moves.size() ? keys[i + 1]
+                                                      : position_key(board, 3 - mover);
+            Move move(moves[i][1], moves[i][2], moves[i][3]);
+            records.push_back({keys[i], child_key, pack_move(move),
+                               mover == PLAYER_A ? outcome_a : -outcome_a});
+        }
+        book.append(records);
+        if (merge) {
+            book.merge_log();
+        }
+    }
+    
+    size_t merge_experience_log() {
+        return book.merge_log();
+    }
+    
+    // (entries, capacity, book moves played since the book was opened)
+    py::tuple get_book_stats() const {
+        return py::make_tuple(book.count(), book.capacity(), book_hits);
+    }
+};
+
+// Cooperative scheduler for many small searches: each search runs for
+// slice_nodes nodes at a time and goes to the back of a round-robin queue,
+// so thousands of searches share a few worker threads with fair latency.
+// All searches share one transposition table.
+class SearchScheduler {
+private:
+    struct Task {
+        uint64_t id;
+        ResumableSearch search;
+        bool has_deadline;
+        std::chrono::steady_clock::time_point deadline;
+        bool done;
+    };
+    
+    SearchEngine engine;
+    uint64_t slice_nodes;
+    uint64_t next_id = 1;
+    bool stopping = false;
+    
+    std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable task_done;
+    std::deque<std::shared_ptr<Task>> run_queue;
+    std::unordered_map<uint64_t, std::shared_ptr<Task>> tasks;
+    std::vector<std::thread> workers;
+    
+    void worker_loop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            work_ready.wait(lock, [this] { return stopping || !run_queue.empty(); });
+            if (stopping) {
+                return;
+            }
+            std::shared_ptr<Task> task = run_queue.front();
+            run_queue.pop_front();
+            lock.unlock();
+            
+            bool finished = engine.resume(task->search, slice_nodes);
+            if (!finished && task->has_deadline &&
+                std::chrono::steady_clock::now() >= task->deadline) {
+                finished = true;  // keep the last completed iteration
+            }
+            
+            lock.lock();
+            if (finished) {
+                task->done = true;
+                task_done.notify_all();
+            } else {
+                run_queue.push_back(task);
+            }
+        }
+    }
+    
+    py::object result_of(const Task& task) const {
+        const ResumableSearch& s = task.search;
+        return py::make_tuple(s.best_move.row, s.best_move.col, s.best_move.value,
+                              s.nodes, s.completed_depth);
+    }
+    
+public:
+    SearchScheduler(int num_workers, uint64_t slice, size_t tt_size)
+        : engine(tt_size), slice_nodes(std::max<uint64_t>(slice, 1)) {
+        if (num_workers <= 0) {
+            num_workers = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (int i = 0; i < num_workers; ++i) {
+            workers.emplace_back(&SearchScheduler::worker_loop, this);
+        }
+    }
+    
+    ~SearchScheduler() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        work_ready.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    
+    // Queue a two-player search; time_ms and nodes of 0 mean no limit.
+    // Returns a ticket for wait()/poll().
+    uint64_t submit(py::list board_2d, int board_size, int player, int depth,
+                    int time_ms, uint64_t nodes) {
+        BoardState board = engine.load_board(board_2d, board_size, 2);
+        auto task = std::make_shared<Task>();
+        engine.start_resumable(task->search, board, player, depth, nodes);
+        task->has_deadline = time_ms > 0;
+        task->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(time_ms);
+        task->done = false;
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        task->id = next_id++;
+        tasks[task->id] = task;
+        run_queue.push_back(task);
+        work_ready.notify_one();
+        return task->id;
+    }
+    
+    // Block until the search finishes (or timeout_ms passes, if >= 0) and
+    // return (row, col, value, nodes, completed_depth), or None on timeout
+    py::object wait(uint64_t id, int timeout_ms) {
+        std::shared_ptr<Task> task;
+        bool finished = true;
+        {
+            py::gil_scoped_release release;
+            std::unique_lock<std::mutex> lock(mutex);
+            auto it = tasks.find(id);
+            if (it == tasks.end()) {
+                throw std::invalid_argument("unknown search id: " + std::to_string(id));
+            }
+            task = it->second;
+            auto ready = [&task] { return task->done; };
+            if (timeout_ms < 0) {
+                task_done.wait(lock, ready);
+            } else {
+                finished = task_done.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready);
+            }
+            if (finished) {
+                tasks.erase(id);
+            }
+        }
+        return finished ? result_of(*task) : py::none();
+    }
+    
+    py::object poll(uint64_t id) {
+        return wait(id, 0);
+    }
+    
+    // Searches submitted but not yet collected
+    size_t pending() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tasks.size();
+    }
+};
+
+// Batched environment for reinforcement learning: steps num_envs games at
+// once from an array of actions (cell index row * size + col), writing
+// observation planes, legal-move masks, rewards and done flags into
+// buffers it owns. Finished games are reset automatically. Both players
+// are the agent (self-play) unless opponent_depth > 0, in which case the
+// agent is player A and the engine answers for player B.
+class VectorEnv {
+public:
+    // Observation planes, from the point of view of the player to move
+    static constexpr int NUM_PLANES = 4;  // own cells, opponent cells, own values, opponent values
+    
+private:
+    struct Game {
+        BoardState board;
+        int to_move;
+    };
+    
+    int num_envs;
+    int board_size;
+    int cells;
+    int opponent_depth;
+    SearchEngine engine;
+    WorkerPool pool;
+    std::vector<Game> games;
+    
+    std::vector<float> observations;   // num_envs x NUM_PLANES x size x size
+    std::vector<uint8_t> legal_masks;  // num_envs x size*size
+    std::vector<float> rewards;
+    std::vector<uint8_t> dones;
+    
+    void reset_game(Game& game) {
+        game.board = BoardState(board_size);
+        game.board.set_cell(0, 0, PLAYER_A, 1);
+        game.board.set_cell(board_size - 1, board_size - 1, PLAYER_B, 1);
+        game.to_move = PLAYER_A;
+    }
+    
+    // Hand the turn to the next player who can move (the game is not over)
+    void advance_turn(Game& game) {
+        int next = 3 - game.to_move;
+        if (engine.count_mobility(game.board, next) > 0) {
+            game.to_move = next;
+        }
+    }
+    
+    int outcome_for(const BoardState& board, int player) const {
+        int own = board.player_max_values[player], other = board.player_max_values[3 - player];
+        return (own > other) - (own < other);
+    }
+    
+    // Engine replies for player B until the agent (player A) is to move
+    void play_opponent(Game& game) {
+        while (game.to_move == PLAYER_B && !engine.is_game_over(game.board)) {
+            std::atomic<uint64_t> shared_nodes(0);
+            std::atomic<bool> stop(false);
+            SearchContext ctx;
+            ctx.shared_nodes = &shared_nodes;
+            ctx.stop = &stop;
+            Move reply = engine.iterative_deepening(ctx, game.board, PLAYER_B, 1,
+                                                    SearchEngine::depth_cap(game.board, opponent_depth));
+            if (reply.value == 0) {
+                reply = engine.first_ordered_move(game.board, PLAYER_B);
+            }
+            engine.make_move(game.board, reply, PLAYER_B);
+            advance_turn(game);
+        }
+    }
+    
+    void write_observation(size_t i) {
+        const Game& game = games[i];
+        const BoardState& board = game.board;
+        int own = game.to_move;
+        float* planes = &observations[i * NUM_PLANES * cells];
+        std::fill(planes, planes + NUM_PLANES * cells, 0.0f);
+        float scale = 1.0f / cells;
+        
+        for (int r = 0; r < board_size; ++r) {
+            for (int c = 0; c < board_size; ++c) {
+                int cell = board.board[r][c];
+                if (cell == 0) continue;
+                int k = r * board_size + c;
+                bool mine = cell / 100 == own;
+                planes[(mine ? 0 : 1) * cells + k] = 1.0f;
+                planes[(mine ? 2 : 3) * cells + k] = (cell % 100) * scale;
+            }
+        }
+        
+        uint8_t* mask = &legal_masks[i * cells];
+        std::fill(mask, mask + cells, 0);
+        if (!engine.is_game_over(board)) {
+            for (const auto& move : engine.generate_moves(board, own)) {
+                mask[move.row * board_size + move.col] = 1;
+            }
+        }
+    }
+    
+    void step_game(size_t i, int action) {
+        Game& game = games[i];
+        int mover = game.to_move;
+        rewards[i] = 0.0f;
+        dones[i] = 0;
+        
+        Move chosen;
+        for (const auto& move : engine.generate_moves(game.board, mover)) {
+            if (move.row * board_size + move.col == action) {
+                chosen = move;
+                break;
+            }
+        }
+        if (chosen.value == 0) {
+            // Illegal action loses the game
+            rewards[i] = -1.0f;
+            dones[i] = 1;
+        } else {
+            engine.make_move(game.board, chosen, mover);
+            if (!engine.is_game_over(game.board)) {
+                advance_turn(game);
+                if (opponent_depth > 0) {
+                    play_opponent(game);
+                }
+            }
+            if (engine.is_game_over(game.board)) {
+                rewards[i] = static_cast<float>(outcome_for(game.board, mover));
+                dones[i] = 1;
+            }
+        }
+        
+        if (dones[i]) {
+            reset_game(game);
+        }
+        write_observation(i);
+    }
+    
+    template <class T>
+    py::array_t<T> view(std::vector<T>& buffer, std::vector<ssize_t> shape) {
+        // Array over the env's own buffer; the env is kept alive as its base
+        return py::array_t<T>(shape, buffer.data(), py::cast(this));
+    }
+    
+    py::tuple snapshot(bool with_rewards) {
+        auto obs = view(observations, {num_envs, NUM_PLANES, board_size, board_size});
+        auto legal = view(legal_masks, {num_envs, cells});
+        if (!with_rewards) {
+            return py::make_tuple(obs, legal);
+        }
+        return py::make_tuple(obs, view(rewards, {num_envs}), view(dones, {num_envs}), legal);
+    }
+    
+public:
+    VectorEnv(int envs, int size, int opponent, int threads)
+        : num_envs(envs), board_size(size), cells(size * size), opponent_depth(opponent),
+          engine(opponent > 0 ? 1 << 16 : 1024), pool(threads) {
+        if (envs < 1) {
+            throw std::invalid_argument("num_envs must be positive");
+        }
+        if (size < 2 || size > MAX_BOARD_SIZE) {
+            throw std::invalid_argument("board_size must be between 2 and " +
+                                        std::to_string(MAX_BOARD_SIZE));
+        }
+        games.resize(envs);
+        observations.resize(static_cast<size_t>(envs) * NUM_PLANES * cells);
+        legal_masks.resize(static_cast<size_t>(envs) * cells);
+        rewards.resize(envs);
+        dones.resize(envs);
+    }
+    
+    // Reset every game; returns (observations, legal_masks)
+    py::tuple reset() {
+        {
+            py::gil_scoped_release release;
+            pool.parallel_for(games.size(), [this](size_t i) {
+                reset_game(games[i]);
+                write_observation(i);
+            });
+        }
+        return snapshot(false);
+    }
+    
+    // Apply one action per game; returns (observations, rewards, dones,
+    // legal_masks). Rewards are for the player who acted: +1 win, -1 loss
+    // (or illegal action), 0 otherwise. The arrays are views of the env's
+    // buffers and are overwritten by the next step.
+    py::tuple step(py::array_t<int32_t, py::array::c_style | py::array::forcecast> actions) {
+        if (actions.ndim() != 1 || actions.shape(0) != num_envs) {
+            throw std::invalid_argument("actions must have shape (num_envs,)");
+        }
+        std::vector<int32_t> chosen(actions.data(), actions.data() + num_envs);
+        {
+            py::gil_scoped_release release;
+            pool.parallel_for(games.size(), [this, &chosen](size_t i) {
+                step_game(i, chosen[i]);
+            });
+        }
+        return snapshot(true);
+    }
+    
+    int get_num_envs() const { return num_envs; }
+    int get_board_size() const { return board_size; }
+};
+
+// Two-player engine for large exhibition boards (up to 64x64), where full
+// board scans are wasteful because only a thin frontier around each
+// territory matters. Occupied cells live in a hash map and each player has
+// a frontier: the empty cells next to their territory, with the value a
+// move there would take. make_move/unmake_move update both incrementally
+// through an undo log, so move generation costs O(frontier) and evaluation
+// O(1) (mobility is the frontier size). The position key is an incremental
+// Zobrist-style hash of the occupied cells.
+class SparseEngine {
+private:
+    struct FrontierChange {
+        int player;
+        int square;
+        int old_value;  // 0 if the square was not on the frontier
+    };
+    
+    struct Undo {
+        size_t log_size;
+        int old_max;
+    };
+    
+    int size = 0;
+    std::unordered_map<int, int> cells;                // square -> player << 16 | value
+    std::unordered_map<int, int> frontier[PLAYER_B + 1];  // square -> value of a move there
+    int max_value[PLAYER_B + 1] = {};
+    int cell_count[PLAYER_B + 1] = {};
+    uint64_t key = 0;
+    std::vector<FrontierChange> log;
+    std::vector<Undo> undo;
+    
+    TranspositionTable tt;
+    uint64_t nodes = 0;
+    uint64_t node_budget = 0;
+    bool stopped = false;
+    
+    // Evaluation weights, shared with the dense engine's (see SearchParams)
+    SearchParams params;
+    
+    static uint64_t cell_key(int square, int player, int value) {
+        return mix64((static_cast<uint64_t>(square) << 24) | (player << 16) | value);
+    }
+    
+    void raise_frontier(int player, int square, int value, bool logged) {
+        auto it = frontier[player].find(square);
+        if (it == frontier[player].end()) {
+            if (logged) log.push_back({player, square, 0});
+            frontier[player].emplace(square, value);
+        } else if (it->second < value) {
+            if (logged) log.push_back({player, square, it->second});
+            it->second = value;
+        }
+    }
+    
+    // Put a cell on the board and extend its owner's frontier around it
+    void place(int square, int player, int value, bool logged) {
+        cells[square] = player << 16 | value;
+        cell_count[player]++;
+        max_value[player] = std::max(max_value[player], value);
+        key ^= cell_key(square, player, value);
+        
+        for (int p = PLAYER_A; p <= PLAYER_B; ++p) {
+            auto it = frontier[p].find(square);
+            if (it != frontier[p].end()) {
+                if (logged) log.push_back({p, square, it->second});
+                frontier[p].erase(it);
+            }
+        }
+        
+        int row = square / size, col = square % size;
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                int r = row + dr, c = col + dc;
+                if ((dr == 0 && dc == 0) || r < 0 || r >= size || c < 0 || c >= size) continue;
+                int neighbor = r * size + c;
+                if (cells.find(neighbor) == cells.end()) {
+                    raise_frontier(player, neighbor, value + 1, logged);
+                }
+            }
+        }
+    }
+    
+    void make_move(const Move& move, int player) {
+        undo.push_back({log.size(), max_value[player]});
+        place(move.row * size + move.col, player, move.value, true);
+    }
+    
+    void unmake_move(const Move& move, int player) {
+        Undo entry = undo.back();
+        undo.pop_back();
+        while (log.size() > entry.log_size) {
+            const FrontierChange& change = log.back();
+            if (change.old_value) {
+                frontier[change.player][change.square] = change.old_value;
+            } else {
+                frontier[change.player].erase(change.square);
+            }
+            log.pop_back();
+        }
+        int square = move.row * size + move.col;
+        cells.erase(square);
+        cell_count[player]--;
+        max_value[player] = entry.old_max;
+        key ^= cell_key(square, player, move.value);
+    }
+    
+    // Frontier moves, best first: higher values, then nearer the centre
+    std::vector<Move> generate_moves(int player, const Move& hash_move) const {
+        std::vector<Move> moves;
+        moves.reserve(frontier[player].size());
+        int center = size / 2;
+        for (const auto& entry : frontier[player]) {
+            int row = entry.first / size, col = entry.first % size;
+            int dist = std::abs(row - center) + std::abs(col - center);
+            int score = entry.second * (4 * MAX_SPARSE_BOARD_SIZE) + (2 * size - dist);
+            // The value is implied by the square, so the hash move matches on
+            // coordinates alone (the TT keeps only 10 bits of value)
+            if (row == hash_move.row && col == hash_move.col) {
+                score = std::numeric_limits<int>::max();
+            }
+            moves.emplace_back(row, col, entry.second, score);
+        }
+        std::sort(moves.begin(), moves.end(), [this](const Move& a, const Move& b) {
+            if (a.score != b.score) return a.score > b.score;
+            return a.row * size + a.col < b.row * size + b.col;
+        });
+        return moves;
+    }
+    
+    int evaluate(int player) const {
+        int opponent = 3 - player;
+        int max_diff = max_value[player] - max_value[opponent];
+        int cell_diff = cell_count[player] - cell_count[opponent];
+        int mobility_diff = static_cast<int>(frontier[player].size()) -
+                            static_cast<int>(frontier[opponent].size());
+        return max_diff * params.max_value_weight + cell_diff * params.cell_weight +
+               mobility_diff * params.mobility_weight;
+    }
+    
+    bool is_game_over() const {
+        return frontier[PLAYER_A].empty() && frontier[PLAYER_B].empty();
+    }
+    
+    int minimax(int depth, int alpha, int beta, int to_move, int root, Move& best_move) {
+        if (stopped || (node_budget && nodes >= node_budget)) {
+            stopped = true;
+            return 0;
+        }
+        nodes++;
+        
+        uint64_t hash = key ^ (static_cast<uint64_t>(to_move) * 0x9E3779B97F4A7C15ULL)
+                          ^ (static_cast<uint64_t>(root) * 0xC2B2AE3D27D4EB4FULL);
+        Move tt_move(-1, -1, 0);
+        int tt_score;
+        if (tt.probe(hash, depth, alpha, beta, tt_score, tt_move)) {
+            // The table keeps only the low bits of the value; a frontier
+            // square implies the whole of it
+            auto square = frontier[to_move].find(tt_move.row * size + tt_move.col);
+            if (square != frontier[to_move].end()) {
+                tt_move.value = square->second;
+            }
+            best_move = tt_move;
+            return tt_score;
+        }
+        
+        if (depth == 0 || is_game_over()) {
+            int score = evaluate(root);
+            tt.store(hash, depth, score, 0, best_move);
+            return score;
+        }
+        
+        int next = 3 - to_move;
+        if (frontier[to_move].empty()) {
+            return minimax(depth - 1, alpha, beta, next, root, best_move);
+        }
+        
+        std::vector<Move> moves = generate_moves(to_move, tt_move);
+        bool maximizing = (to_move == root);
+        int alpha_orig = alpha, beta_orig = beta;
+        int best_eval = maximizing ? std::numeric_limits<int>::min()
+                                   : std::numeric_limits<int>::max();
+        Move local_best;
+        
+        for (const auto& move : moves) {
+            make_move(move, to_move);
+            Move dummy;
+            int eval = minimax(depth - 1, alpha, beta, next, root, dummy);
+            unmake_move(move, to_move);
+            if (stopped) {
+                return 0;
+            }
+            
+            if (maximizing ? eval > best_eval : eval < best_eval) {
+                best_eval = eval;
+                local_best = move;
+            }
+            if (maximizing) {
+                alpha = std::max(alpha, eval);
+            } else {
+                beta = std::min(beta, eval);
+            }
+            if (beta <= alpha) {
+                break;
+            }
+        }
+        
+        int flag = best_eval <= alpha_orig ? 2 : (best_eval >= beta_orig ? 1 : 0);
+        tt.store(hash, depth, best_eval, flag, local_best);
+        best_move = local_best;
+        return best_eval;
+    }
+    
+public:
+    explicit SparseEngine(size_t tt_size = 1048576) : tt(std::max<size_t>(tt_size, 1024)) {}
+    
+    // Set up a position from (row, col, player, value) cells
+    void load(const std::vector<std::array<int, 4>>& occupied, int board_size) {
+        if (board_size < 1 || board_size > MAX_SPARSE_BOARD_SIZE) {
+            throw std::invalid_argument("board_size must be between 1 and " +
+                                        std::to_string(MAX_SPARSE_BOARD_SIZE));
+        }
+        size = board_size;
+        cells.clear();
+        cells.reserve(occupied.size() * 2);
+        for (int p = PLAYER_A; p <= PLAYER_B; ++p) {
+            frontier[p].clear();
+            max_value[p] = 0;
+            cell_count[p] = 0;
+        }
+        key = 0;
+        log.clear();
+        undo.clear();
+        
+        for (const auto& cell : occupied) {
+            int row = cell[0], col = cell[1], player = cell[2], value = cell[3];
+            if (row < 0 || row >= size || col < 0 || col >= size) {
+                throw std::invalid_argument("cell out of range: (" + std::to_string(row) +
+                                            ", " + std::to_string(col) + ")");
+            }
+            if (player < PLAYER_A || player > PLAYER_B) {
+                throw std::invalid_argument("cell owner out of range: " + std::to_string(player));
+            }
+            if (value < 1 || value > 0xFFFF || cells.count(row * size + col)) {
+                throw std::invalid_argument("bad cell at (" + std::to_string(row) + ", " +
+                                            std::to_string(col) + ")");
+            }
+            place(row * size + col, player, value, false);
+        }
+    }
+    
+    // Python interface: cells is a list of (row, col, player, value) for the
+    // occupied squares only. Iterative deepening up to depth, stopping after
+    // nodes nodes if nodes > 0; returns (row, col, value, nodes).
+    py::tuple find_best_move(const std::vector<std::array<int, 4>>& occupied, int board_size,
+                             int player, int depth, uint64_t node_limit) {
+        if (player != PLAYER_A && player != PLAYER_B) {
+            throw std::invalid_argument("player out of range: " + std::to_string(player));
+        }
+        load(occupied, board_size);
+        
+        Move best_move;
+        {
+            py::gil_scoped_release release;
+            best_move = search(player, depth, node_limit);
+        }
+        return py::make_tuple(best_move.row, best_move.col, best_move.value, nodes);
+    }
+    
+    // Iterative deepening on the loaded position
+    Move search(int player, int depth, uint64_t node_limit) {
+        Move best_move;
+        nodes = 0;
+        node_budget = node_limit;
+        stopped = false;
+        for (int d = 1; d <= std::max(depth, 1); ++d) {
+            Move iteration_best;
+            minimax(d, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(),
+                    player, player, iteration_best);
+            if (stopped) {
+                break;
+            }
+            best_move = iteration_best;
+        }
+        if (best_move.value == 0 && !frontier[player].empty()) {
+            // Not even depth 1 finished within the budget
+            best_move = generate_moves(player, Move(-1, -1, 0))[0];
+        }
+        return best_move;
+    }
+    
+    uint64_t get_nodes() const {
+        return nodes;
+    }
+    
+    size_t frontier_size(int player) const {
+        if (player != PLAYER_A && player != PLAYER_B) {
+            throw std::invalid_argument("player out of range: " + std::to_string(player));
+        }
+        return frontier[player].size();
+    }
+    
+    void clear_tt() {
+        tt.clear();
+    }
+    
+    void set_params(const std::map<std::string, int>& values) {
+        params.set(values);
+        clear_tt();
+    }
+    
+    std::map<std::string, int> get_params() const {
+        return params.values();
+    }
+};
+
+// Native self-play match between two parameter sets, for tuning. Games
+// start from the standard position plus random_plies random moves (seeded
+// per pair of games) and are played in pairs with colours swapped, on
+// parallel workers with one small engine per side. Each move is an
+// iterative deepening search to depth, capped at nodes nodes if nodes > 0.
+// Returns (wins, losses, draws) for params_a.
+py::tuple play_match(const std::map<std::string, int>& params_a,
+                     const std::map<std::string, int>& params_b, int games, int board_size,
+                     int depth, uint64_t nodes, int random_plies, int threads, uint64_t seed) {
+    if (board_size < 2 || board_size > MAX_BOARD_SIZE) {
+        throw std::invalid_argument("board_size must be between 2 and " +
+                                    std::to_string(MAX_BOARD_SIZE));
+    }
+    SearchParams first, second;
+    first.set(params_a);
+    second.set(params_b);
+    
+    std::vector<int> results(std::max(games, 0));
+    {
+        py::gil_scoped_release release;
+        WorkerPool pool(threads);
+        pool.parallel_for(results.size(), [&](size_t game) {
+            // Side 1 plays A in even games, B in odd ones
+            SearchEngine engines[2] = {SearchEngine(1 << 14), SearchEngine(1 << 14)};
+            engines[0].params = (game % 2 == 0) ? first : second;
+            engines[1].params = (game % 2 == 0) ? second : first;
+            
+            BoardState board(board_size);
+            board.set_cell(0, 0, PLAYER_A, 1);
+            board.set_cell(board_size - 1, board_size - 1, PLAYER_B, 1);
+            std::mt19937_64 rng(seed * 0x9E3779B97F4A7C15ULL + game / 2);
+            int player = PLAYER_A;
+            
+            for (int ply = 0; !engines[0].is_game_over(board); ++ply) {
+                SearchEngine& engine = engines[player - 1];
+                auto moves = engine.generate_moves(board, player);
+                if (!moves.empty()) {
+                    Move move;
+                    if (ply < random_plies) {
+                        move = moves[rng() % moves.size()];
+                    } else {
+                        engine.parallel_search(board, player, depth, nodes, 1, move);
+                    }
+                    engine.make_move(board, move, player);
+                }
+                player = 3 - player;
+            }
+            
+            int a = board.player_max_values[PLAYER_A], b = board.player_max_values[PLAYER_B];
+            int outcome = (a > b) - (a < b);  // for player A
+            results[game] = (game % 2 == 0) ? outcome : -outcome;
+        });
+    }
+    
+    int wins = 0, losses = 0, draws = 0;
+    for (int result : results) {
+        wins += result > 0;
+        losses += result < 0;
+        draws += result == 0;
+    }
+    return py::make_tuple(wins, losses, draws);
+}
+
+// Streaming analysis of a game archive: a reader thread decodes game
+// records, a pool of search workers (one engine each) analyses every
+// position of a game, and the writer (the calling thread) emits annotated
+// records in input order. Stages are connected by bounded lock-free queues,
+// so memory stays constant however large the archive is.
+//
+// Input: one game per line, "size p,r,c,v p,r,c,v ..." (two players from
+// the standard start; blank lines and lines starting with '#' are skipped).
+// Output: one JSON object per game with, for every move, the engine's best
+// move and its score for the mover, and whether the played move matched.
+class AnalysisPipeline {
+private:
+    struct GameRecord {
+        size_t index = 0;
+        int size = 0;
+        std::vector<std::array<int, 4>> moves;
+    };
+    
+    struct AnnotatedGame {
+        size_t index = 0;
+        std::string json;
+    };
+    
+    int depth;
+    uint64_t node_limit;
+    int num_workers;
+    size_t tt_size;
+    
+    BoundedQueue<GameRecord> games;
+    BoundedQueue<AnnotatedGame> annotated;
+    std::atomic<bool> reading_done{false};
+    std::atomic<int> workers_running{0};
+    std::atomic<uint64_t> positions{0};
+    std::atomic<uint64_t> nodes{0};
+    std::atomic<uint64_t> illegal_games{0};
+    std::atomic<bool> failed{false};
+    std::string error;  // set by the reader before failed
+    
+    static bool parse(const std::string& line, GameRecord& record) {
+        const char* p = line.c_str();
+        int consumed = 0;
+        if (std::sscanf(p, "%d%n", &record.size, &consumed) != 1 ||
+            record.size < 2 || record.size > MAX_BOARD_SIZE) {
+            return false;
+        }
+        p += consumed;
+        record.moves.clear();
+        std::array<int, 4> move;
+        while (std::sscanf(p, " %d,%d,%d,%d%n", &move[0], &move[1], &move[2], &move[3],
+                           &consumed) == 4) {
+            record.moves.push_back(move);
+            p += consumed;
+        }
+        while (*p == ' ' || *p == '\t' || *p == '\r') ++p;
+        return *p == '\0';
+    }
+    
+    void read(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) {
+            error = "cannot open game archive: " + path;
+            failed = true;
+        }
+        std::string line;
+        size_t index = 0, line_number = 0;
+        while (!failed && std::getline(in, line)) {
+            line_number++;
+            size_t start = line.find_first_not_of(" \t\r");
+            if (start == std::string::npos || line[start] == '#') continue;
+            
+            GameRecord record;
+            if (!parse(line, record)) {
+                error = "bad game record on line " + std::to_string(line_number) + " of " + path;
+                failed = true;
+                break;
+            }
+            record.index = index++;
+            int spins = 0;
+            while (!games.try_push(record) && !failed) {
+                queue_backoff(spins);  // backpressure: workers are behind
+            }
+        }
+        reading_done.store(true, std::memory_order_release);
+    }
+    
+    // Best move and its score for the mover, like find_best_move's search
+    static Move analyse_position(SearchEngine& engine, BoardState& board, int player,
+                                 int max_depth, uint64_t budget, int& score, uint64_t& searched) {
+        std::atomic<uint64_t> shared_nodes(0);
+        std::atomic<bool> stop(false);
+        SearchContext ctx;
+        ctx.node_budget = budget;
+        ctx.shared_nodes = &shared_nodes;
+        ctx.stop = &stop;
+        
+        Move best_move;
+        score = 0;
+        for (int d = 1; d <= SearchEngine::depth_cap(board, max_depth); ++d) {
+            Move iteration_best;
+            int iteration_score = engine.minimax(ctx, board, d, std::numeric_limits<int>::min(),
+                                                 std::numeric_limits<int>::max(), player, player,
+                                                 iteration_best);
+            if (stop.load(std::memory_order_relaxed)) {
+                break;
+            }
+            best_move = iteration_best;
+            score = iteration_score;
+        }
+        if (best_move.value == 0) {
+            best_move = engine.first_ordered_move(board, player);
+        }
+        searched = ctx.nodes;
+        return best_move;
+    }
+    
+    static std::string triple(int a, int b, int c) {
+        return "[" + std::to_string(a) + "," + std::to_string(b) + "," + std::to_string(c) + "]";
+    }
+    
+    void analyse(SearchEngine& engine, GameRecord& record, AnnotatedGame& out) {
+        // A fresh table per game keeps the annotations independent of which
+        // worker analysed which games before
+        engine.clear_tt();
+        BoardState board(record.size);
+        board.set_cell(0, 0, PLAYER_A, 1);
+        board.set_cell(record.size - 1, record.size - 1, PLAYER_B, 1);
+        
+        std::string moves_json;
+        std::string error_json;
+        for (size_t ply = 0; ply < record.moves.size(); ++ply) {
+            const auto& m = record.moves[ply];
+            int player = m[0];
+            bool legal = false;
+            if (player == PLAYER_A || player == PLAYER_B) {
+                for (const auto& move : engine.generate_moves(board, player)) {
+                    legal |= move.row == m[1] && move.col == m[2] && move.value == m[3];
+                }
+            }
+            if (!legal) {
+                error_json = ",\"error\":\"illegal move at ply " + std::to_string(ply) + "\"";
+                illegal_games++;
+                break;
+            }
+            
+            int score;
+            uint64_t searched;
+            Move best = analyse_position(engine, board, player, depth, node_limit, score, searched);
+            positions++;
+            nodes += searched;
+            
+            if (ply) moves_json += ",";
+            moves_json += "{\"player\":" + std::to_string(player) +
+                          ",\"played\":" + triple(m[1], m[2], m[3]) +
+                          ",\"best\":" + triple(best.row, best.col, best.value) +
+                          ",\"score\":" + std::to_string(score) +
+                          ",\"match\":" + ((best.row == m[1] && best.col == m[2]) ? "true" : "false") +
+                          "}";
+            engine.make_move(board, Move(m[1], m[2], m[3]), player);
+        }
+        
+        out.index = record.index;
+        out.json = "{\"game\":" + std::to_string(record.index) +
+                   ",\"size\":" + std::to_string(record.size) + error_json +
+                   ",\"moves\":[" + moves_json + "]}\n";
+    }
+    
+    void work() {
+        SearchEngine engine(tt_size);
+        GameRecord record;
+        AnnotatedGame result;
+        int spins = 0;
+        while (!failed) {
+            if (!games.try_pop(record)) {
+                // Check for the end only after a failed pop, then pop once
+                // more: the reader may have pushed its last game in between
+                if (reading_done.load(std::memory_order_acquire) && !games.try_pop(record)) {
+                    break;
+                }
+                if (!reading_done.load(std::memory_order_acquire)) {
+                    queue_backoff(spins);
+                    continue;
+                }
+            }
+            spins = 0;
+            analyse(engine, record, result);
+            int push_spins = 0;
+            while (!annotated.try_push(result) && !failed) {
+                queue_backoff(push_spins);  // backpressure: the writer is behind
+            }
+        }
+        workers_running.fetch_sub(1, std::memory_order_release);
+    }
+    
+public:
+    AnalysisPipeline(int max_depth, uint64_t nodes_per_position, int workers, size_t queue_size,
+                     size_t tt_entries)
+        : depth(max_depth), node_limit(nodes_per_position),
+          num_workers(workers > 0 ? workers
+                                  : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))),
+          tt_size(tt_entries), games(std::max<size_t>(queue_size, 2)),
+          annotated(std::max<size_t>(queue_size, 2)) {}
+    
+    py::dict run(const std::string& input_path, const std::string& output_path) {
+        std::ofstream out(output_path);
+        if (!out) {
+            throw std::runtime_error("cannot write analysis: " + output_path);
+        }
+        
+        size_t written = 0;
+        auto start = std::chrono::steady_clock::now();
+        {
+            py::gil_scoped_release release;
+            workers_running = num_workers;
+            std::thread reader(&AnalysisPipeline::read, this, input_path);
+            std::vector<std::thread> workers;
+            for (int i = 0; i < num_workers; ++i) {
+                workers.emplace_back(&AnalysisPipeline::work, this);
+            }
+            
+            // Writer: restore input order. Out-of-order games wait here, at
+            // most one per game in flight, so this stays bounded too.
+            std::map<size_t, std::string> waiting;
+            AnnotatedGame result;
+            int spins = 0;
+            while (true) {
+                if (annotated.try_pop(result)) {
+                    spins = 0;
+                    waiting[result.index] = std::move(result.json);
+                    while (!waiting.empty() && waiting.begin()->first == written) {
+                        out << waiting.begin()->second;
+                        waiting.erase(waiting.begin());
+                        written++;
+                    }
+                } else if (workers_running.load(std::memory_order_acquire) == 0) {
+                    if (!annotated.try_pop(result)) {
+                        break;
+                    }
+                    waiting[result.index] = std::move(result.json);
+                } else {
+                    queue_backoff(spins);
+                }
+            }
+            for (auto& entry : waiting) {
+                out << entry.second;
+                written++;
+            }
+            
+            reader.join();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+        if (failed) {
+            throw std::runtime_error(error);
+        }
+        
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        py::dict report;
+        report["games"] = written;
+        report["positions"] = positions.load();
+        report["nodes"] = nodes.load();
+        report["illegal_games"] = illegal_games.load();
+        report["workers"] = num_workers;
+        report["seconds"] = seconds;
+        report["positions_per_second"] = seconds > 0 ? positions.load() / seconds : 0.0;
+        return report;
+    }
+};
+
+// Analyse a game archive file into annotated JSON lines (see AnalysisPipeline)
+py::dict analyse_archive(const std::string& input_path, const std::string& output_path,
+                         int depth, uint64_t nodes, int workers, size_t queue_size,
+                         size_t tt_size) {
+    AnalysisPipeline pipeline(depth, nodes, workers, queue_size, tt_size);
+    return pipeline.run(input_path, output_path);
+}
+
+// Python view of a RegionTracker over its own copy of a position
+class RegionMap {
+private:
+    BoardState board;
+    RegionTracker tracker;
+    std::vector<std::pair<Move, int>> moves;  // (move, player) made since loading
+    
+    int square(int row, int col) const {
+        if (row < 0 || row >= board.size || col < 0 || col >= board.size) {
+            throw std::invalid_argument("cell out of range");
+        }
+        return row * MAX_BOARD_SIZE + col;
+    }
+    
+public:
+    RegionMap(py::list board_2d, int board_size, int num_players)
+        : board(SearchEngine::load_board(board_2d, board_size, num_players)) {
+        tracker.reset(board);
+    }
+    
+    void make_move(int row, int col, int player, int value) {
+        int sq = square(row, col);
+        if (board.board[row][col] != 0 || player < 1 || player > board.num_players) {
+            throw std::invalid_argument("illegal move");
+        }
+        Move move(row, col, value);
+        SearchEngine::make_move(board, move, player);
+        tracker.make_move(board, sq);
+        moves.emplace_back(move, player);
+    }
+    
+    void unmake_move() {
+        if (moves.empty()) {
+            throw std::runtime_error("no move to unmake");
+        }
+        tracker.unmake_move();
+        SearchEngine::unmake_move(board, moves.back().first, moves.back().second);
+        moves.pop_back();
+    }
+    
+    bool separated() const {
+        return tracker.separated();
+    }
+    
+    int region_of(int row, int col) const {
+        return tracker.region_of(square(row, col));
+    }
+    
+    // (row, col) cells of the region containing an empty cell
+    std::vector<std::pair<int, int>> region_cells(int row, int col) const {
+        std::vector<std::pair<int, int>> cells;
+        Bitboard region = tracker.region_cells(square(row, col));
+        while (region) {
+            int sq = pop_lsb(region);
+            cells.emplace_back(sq / MAX_BOARD_SIZE, sq % MAX_BOARD_SIZE);
+        }
+        return cells;
+    }
+    
+    int region_count() const {
+        return tracker.region_count();
+    }
+};
+
+// Monte Carlo tree search for two players with RAVE. Besides its own
+// visits, every child keeps all-moves-as-first statistics: how playouts
+// through its parent went when the parent's player claimed the child's
+// square at any later point. Children are generated in square order, so a
+// played square finds its child by a popcount rank over the parent's child
+// squares. Selection blends the two means with
+//   beta = sqrt(k / (3 * visits + k))
+// (k = rave_equivalence, 0 for plain UCT), so AMAF guides a child's early
+// visits and its own mean takes over as they accumulate.
+//
+// Nodes whose outcome is known are proven (MCTS-Solver): game-over leaves,
+// and leaves where the players are separated, which the chain solver settles
+// exactly. A node is proven once one child is proven won for its player to
+// move, or all children are proven; proven children receive no more
+// playouts, and the search stops as soon as the root is proven.
+class MctsEngine {
+public:
+    static constexpr int UNPROVEN = -1;
+    
+    // Work limit per chain solve at a separated leaf
+    static constexpr uint64_t SOLVER_BUDGET = 1 << 16;
+    
+    struct Node {
+        Bitboard child_squares = 0;
+        Move move;                  // move into this node
+        int to_move = 0;            // set on expansion; 0 once the game is over
+        uint32_t first_child = 0;
+        uint32_t num_children = 0;
+        bool expanded = false;
+        uint32_t visits = 0;
+        float wins = 0;             // for the player who made move
+        uint32_t amaf_visits = 0;
+        float amaf_wins = 0;
+        int proven = UNPROVEN;      // winner (0 for a tie) once proven
+    };
+    
+    // Player to move after mover, passing a player without moves; 0 if
+    // neither can move
+    static int next_to_move(const BoardState& board, int mover) {
+        const BoardMasks& masks = board_masks(board.size);
+        for (int p : {3 - mover, mover}) {
+            if (dilate(board.occupancy[p], masks) & ~board.occupancy[0]) {
+                return p;
+            }
+        }
+        return 0;
+    }
+    
+    static int winner(const BoardState& board) {
+        int a = board.player_max_values[PLAYER_A], b = board.player_max_values[PLAYER_B];
+        return a > b ? PLAYER_A : b > a ? PLAYER_B : 0;
+    }
+    
+    static float reward(int winner, int player) {
+        return winner == player ? 1.0f : winner == 0 ? 0.5f : 0.0f;
+    }
+    
+    // Uniformly random moves until neither player can move. Squares claimed
+    // are added to played; returns the winner (0 for a tie).
+    static int playout(BoardState& board, int to_move, Bitboard played[3],
+                       std::mt19937_64& rng) {
+        const BoardMasks& masks = board_masks(board.size);
+        int p = to_move;
+        int passes = 0;
+        while (p && passes < 2) {
+            Bitboard frontier = dilate(board.occupancy[p], masks) & ~board.occupancy[0];
+            if (!frontier) {
+                passes++;
+                p = 3 - p;
+                continue;
+            }
+            passes = 0;
+            for (int skip = static_cast<int>(rng() % popcount(frontier)); skip > 0; --skip) {
+                pop_lsb(frontier);
+            }
+            int sq = pop_lsb(frontier);
+            board.set_cell(sq / MAX_BOARD_SIZE, sq % MAX_BOARD_SIZE, p,
+                           SearchEngine::move_value(board, sq, p));
+            played[p] |= square_bit(sq);
+            p = 3 - p;
+        }
+        return winner(board);
+    }
+    
+    // Outcome of a new leaf if it is decided: the game is over, or the
+    // players are separated and each one's best chain can be solved
+    static int resolve(const BoardState& board, int to_move, RegionTracker& regions) {
+        if (!to_move) {
+            return winner(board);
+        }
+        regions.reset(board);
+        if (!regions.separated()) {
+            return UNPROVEN;
+        }
+        int final_max[3] = {0, 0, 0};
+        for (int p : {PLAYER_A, PLAYER_B}) {
+            auto moves = SearchEngine::generate_moves(board, p);
+            std::sort(moves.begin(), moves.end(),
+                      [](const Move& a, const Move& b) { return a.value > b.value; });
+            ChainSolver solver(board.size, SOLVER_BUDGET);
+            Move first;
+            if (!solver.solve(board, p, moves, final_max[p], first)) {
+                return UNPROVEN;
+            }
+        }
+        return final_max[PLAYER_A] > final_max[PLAYER_B]   ? PLAYER_A
+               : final_max[PLAYER_B] > final_max[PLAYER_A] ? PLAYER_B
+                                                           : 0;
+    }
+    
+    // Selection score of a move with the given own and AMAF results (wins
+    // out of visits) under a parent with log(visits + 1) = log_visits
+    static double uct_score(double wins, uint32_t visits, double amaf_wins,
+                            uint32_t amaf_visits, double log_visits, double exploration,
+                            double rave_equivalence) {
+        double q = visits ? wins / visits : 0.0;
+        double amaf = amaf_visits ? amaf_wins / amaf_visits : 0.0;
+        double beta = 0.0;
+        if (amaf_visits && rave_equivalence > 0.0) {
+            beta = std::sqrt(rave_equivalence / (3.0 * visits + rave_equivalence));
+        }
+        return (1.0 - beta) * q + beta * amaf +
+               exploration * std::sqrt(log_visits / (visits + 1.0));
+    }
+    
+private:
+    double exploration;
+    double rave_equivalence;
+    size_t max_nodes;
+    std::mt19937_64 rng;
+    std::vector<Node> nodes;
+    uint64_t playouts = 0;
+    RegionTracker regions;
+    
+    void expand(uint32_t index, const BoardState& board, int to_move) {
+        Node& node = nodes[index];
+        node.expanded = true;
+        node.to_move = to_move;
+        if (!to_move) {
+            node.proven = winner(board);
+            return;
+        }
+        auto moves = SearchEngine::generate_moves(board, to_move);
+        if (nodes.size() + moves.size() > max_nodes) {
+            node.expanded = false;  // out of room: keep playing out from here
+            return;
+        }
+        node.first_child = static_cast<uint32_t>(nodes.size());
+        node.num_children = static_cast<uint32_t>(moves.size());
+        for (const auto& move : moves) {
+            node.child_squares |= square_bit(move.row * MAX_BOARD_SIZE + move.col);
+        }
+        for (const auto& move : moves) {
+            nodes.emplace_back();
+            nodes.back().move = move;
+        }
+    }
+    
+    uint32_t select(const Node& node) const {
+        double log_visits = std::log(static_cast<double>(node.visits) + 1.0);
+        uint32_t best = node.first_child;
+        double best_score = -1.0;
+        for (uint32_t i = node.first_child; i < node.first_child + node.num_children; ++i) {
+            const Node& child = nodes[i];
+            if (child.proven != UNPROVEN) {
+                continue;
+            }
+            // Unvisited children come first; under RAVE, AMAF results count
+            if (child.visits == 0 && (child.amaf_visits == 0 || rave_equivalence == 0.0)) {
+                return i;
+            }
+            double score = uct_score(child.wins, child.visits, child.amaf_wins,
+                                     child.amaf_visits, log_visits, exploration,
+                                     rave_equivalence);
+            if (score > best_score) {
+                best_score = score;
+                best = i;
+            }
+        }
+        return best;
+    }
+    
+    // Prove an expanded node from its children; true if it became proven
+    bool prove(Node& node) {
+        if (node.proven != UNPROVEN || !node.expanded || !node.num_children) {
+            return false;
+        }
+        bool all = true, tie = false;
+        for (uint32_t i = node.first_child; i < node.first_child + node.num_children; ++i) {
+            int outcome = nodes[i].proven;
+            if (outcome == node.to_move) {
+                node.proven = outcome;
+                return true;
+            }
+            all = all && outcome != UNPROVEN;
+            tie = tie || outcome == 0;
+        }
+        if (all) {
+            node.proven = tie ? 0 : 3 - node.to_move;
+        }
+        return all;
+    }
+    
+    void iterate(const BoardState& root_board, std::vector<uint32_t>& path) {
+        BoardState board = root_board;
+        path.assign(1, 0);
+        uint32_t index = 0;
+        while (nodes[index].expanded && nodes[index].num_children) {
+            int mover = nodes[index].to_move;
+            index = select(nodes[index]);
+            SearchEngine::make_move(board, nodes[index].move, mover);
+            path.push_back(index);
+        }
+        if (!nodes[index].expanded && (nodes[index].visits || index == 0)) {
+            int mover = path.size() > 1 ? nodes[path[path.size() - 2]].to_move : 0;
+            expand(index, board, index == 0 ? nodes[0].to_move : next_to_move(board, mover));
+            if (nodes[index].expanded && nodes[index].num_children) {
+                int to_move = nodes[index].to_move;
+                index = select(nodes[index]);
+                SearchEngine::make_move(board, nodes[index].move, to_move);
+                path.push_back(index);
+            }
+        }
         
-        // Convert Python board to internal representation
-        BoardState board(board_size);
-        board.size = board_size;
+        int to_move;
+        if (nodes[index].expanded) {
+            to_move = nodes[index].to_move;
+        } else {
+            // An unexpanded root keeps the player it was set up with
+            to_move = path.size() == 1 ? nodes[0].to_move
+                                       : next_to_move(board, nodes[path[path.size() - 2]].to_move);
+            if (nodes[index].visits == 0) {
+                nodes[index].proven = resolve(board, to_move, regions);
+            }
+        }
+        Bitboard played[3] = {0, 0, 0};
+        int winner = nodes[index].proven;
+        if (winner == UNPROVEN) {
+            winner = playout(board, to_move, played, rng);
+        }
+        playouts++;
         
-        for (int i = 0; i < board_size; ++i) {
-            py::list row = board_2d[i];
-            for (int j = 0; j < board_size; ++j) {
-                py::object cell = row[j];
-                
-                if (cell.is_none()) {
-                    board.board[i][j] = 0;
-                } else {
-                    py::tuple cell_tuple = cell.cast<py::tuple>();
-                    int player_id = cell_tuple[0].cast<int>();
-                    int value = cell_tuple[1].cast<int>();
-                    board.board[i][j] = player_id * 100 + value;
-                    
-                    // Track max values
-                    if (value > board.player_max_values[player_id]) {
-                        board.player_max_values[player_id] = value;
+        // Back up from the leaf, adding each tree move to the played squares
+        // once the nodes below it are done
+        for (size_t i = path.size(); i-- > 0;) {
+            Node& node = nodes[path[i]];
+            node.visits++;
+            if (i > 0) {
+                node.wins += reward(winner, nodes[path[i - 1]].to_move);
+            }
+            if (node.expanded && node.num_children) {
+                float r = reward(winner, node.to_move);
+                Bitboard hits = played[node.to_move] & node.child_squares;
+                while (hits) {
+                    Bitboard bit = square_bit(pop_lsb(hits));
+                    Node& child = nodes[node.first_child + popcount(node.child_squares & (bit - 1))];
+                    child.amaf_visits++;
+                    child.amaf_wins += r;
+                }
+            }
+            if (i > 0) {
+                const Move& move = node.move;
+                played[nodes[path[i - 1]].to_move] |= square_bit(move.row * MAX_BOARD_SIZE + move.col);
+            }
+        }
+        
+        for (size_t i = path.size() - 1; i-- > 0;) {
+            if (!prove(nodes[path[i]])) {
+                break;
+            }
+        }
+    }
+    
+    // A move proven to win for the root player, else the most visited
+    // unproven move, unless a proven tie is better than its mean; a proven
+    // loss only if nothing else is left
+    uint32_t best_child() const {
+        const Node& root = nodes[0];
+        int player = root.to_move;
+        uint32_t best = root.first_child, tie = 0, visited = 0;
+        for (uint32_t i = root.first_child; i < root.first_child + root.num_children; ++i) {
+            const Node& child = nodes[i];
+            if (child.proven == player) {
+                return i;
+            }
+            if (child.proven == 0 && !tie) {
+                tie = i;
+            } else if (child.proven == UNPROVEN &&
+                       (!visited || child.visits > nodes[visited].visits)) {
+                visited = i;
+            }
+        }
+        if (visited && tie) {
+            const Node& child = nodes[visited];
+            return child.visits && child.wins / child.visits >= 0.5f ? visited : tie;
+        }
+        return visited ? visited : tie ? tie : best;
+    }
+    
+public:
+    MctsEngine(double exploration_constant = 0.4, double rave_k = 1000.0,
+               size_t node_limit = 1 << 20, uint64_t seed = 0)
+        : exploration(exploration_constant), rave_equivalence(rave_k), max_nodes(node_limit),
+          rng(seed) {
+        if (exploration < 0.0 || rave_equivalence < 0.0) {
+            throw std::invalid_argument("exploration and rave_equivalence must be non-negative");
+        }
+        if (max_nodes < 2) {
+            throw std::invalid_argument("node_limit must be at least 2");
+        }
+    }
+    
+    // Run playouts from a fresh tree until the playout or time limit (0 =
+    // none; at least one must be set) and return the most visited move
+    Move search(const BoardState& board, int player, uint64_t max_playouts, double time_ms) {
+        if (board.num_players != 2) {
+            throw std::invalid_argument("MCTS supports two players");
+        }
+        if (!max_playouts && time_ms <= 0.0) {
+            throw std::invalid_argument("set a playout or time limit");
+        }
+        nodes.clear();
+        nodes.reserve(std::min<size_t>(max_nodes, 1 << 16));
+        nodes.emplace_back();
+        playouts = 0;
+        size_t root_moves = SearchEngine::generate_moves(board, player).size();
+        if (!root_moves) {
+            return Move();
+        }
+        if (1 + root_moves > max_nodes) {
+            throw std::invalid_argument("node_limit " + std::to_string(max_nodes) +
+                                        " cannot hold the root and its " +
+                                        std::to_string(root_moves) + " moves");
+        }
+        expand(0, board, player);
+        
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::microseconds(static_cast<int64_t>(time_ms * 1000.0));
+        std::vector<uint32_t> path;
+        while ((!max_playouts || playouts < max_playouts) && nodes[0].proven == UNPROVEN) {
+            if (time_ms > 0.0 && (playouts & 63) == 0 &&
+                std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+            iterate(board, path);
+        }
+        
+        return nodes[best_child()].move;
+    }
+    
+    // Python interface: (row, col, value, playouts)
+    py::tuple find_best_move(py::list board_2d, int board_size, int player,
+                             uint64_t max_playouts, double time_ms) {
+        BoardState board = SearchEngine::load_board(board_2d, board_size, 2);
+        Move best_move;
+        {
+            py::gil_scoped_release release;
+            best_move = search(board, player, max_playouts, time_ms);
+        }
+        return py::make_tuple(best_move.row, best_move.col, best_move.value, playouts);
+    }
+    
+    // Root children of the last search as (row, col, value, visits, mean,
+    // amaf visits, amaf mean, proven winner or -1)
+    std::vector<py::tuple> get_root_stats() const {
+        std::vector<py::tuple> stats;
+        if (nodes.empty()) {
+            return stats;
+        }
+        const Node& root = nodes[0];
+        for (uint32_t i = root.first_child; i < root.first_child + root.num_children; ++i) {
+            const Node& child = nodes[i];
+            stats.push_back(py::make_tuple(
+                child.move.row, child.move.col, child.move.value, child.visits,
+                child.visits ? child.wins / child.visits : 0.0, child.amaf_visits,
+                child.amaf_visits ? child.amaf_wins / child.amaf_visits : 0.0, child.proven));
+        }
+        return stats;
+    }
+    
+    uint64_t get_playouts() const {
+        return playouts;
+    }
+    
+    // Proven outcome of the last search's root: the winner (0 for a tie),
+    // or -1 if it was not solved
+    int get_proven() const {
+        return nodes.empty() ? UNPROVEN : nodes[0].proven;
+    }
+    
+    size_t tree_size() const {
+        return nodes.size();
+    }
+};
+
+// Monte Carlo graph search: transposed positions share one node, found by
+// Zobrist key in a fixed-capacity lock-free table, so every move order that
+// reaches a position adds to (and profits from) the same statistics. Edges
+// keep their own visits for exploration, AMAF results and the final choice,
+// while a move's mean comes from the shared child node (UCD). Any number of
+// threads search one graph, with a visit counted on an edge on the way down
+// as virtual loss. The table outlives a search, so the next move starts from
+// what earlier searches learnt, and is cleared when it is over three
+// quarters full at the start of one. Proven outcomes back up as in
+// MctsEngine, along the path of the iteration that proved them.
+class TranspositionMcts {
+public:
+    enum : uint8_t { UNEXPANDED, EXPANDING, EXPANDED };
+    
+    struct Node {
+        std::atomic<uint64_t> key{0};
+        std::atomic<uint32_t> visits{0};
+        std::atomic<uint32_t> wins_a{0};   // 2 per player A win, 1 per tie
+        std::atomic<uint8_t> state{UNEXPANDED};
+        std::atomic<int8_t> proven{MctsEngine::UNPROVEN};
+        // Published by the release store of state = EXPANDED
+        int8_t to_move = 0;
+        uint16_t num_edges = 0;
+        uint32_t first_edge = 0;
+        Bitboard edge_squares = 0;
+    };
+    
+    struct Edge {
+        Move move;
+        std::atomic<uint32_t> child{0};    // node index + 1, once looked up
+        std::atomic<uint32_t> visits{0};
+        std::atomic<uint32_t> wins{0};     // for the mover: 2 per win, 1 per tie
+        std::atomic<uint32_t> amaf_visits{0};
+        std::atomic<uint32_t> amaf_wins{0};
+    };
+    
+    // Edges reserved per node slot when splitting the memory cap
+    static constexpr size_t EDGES_PER_NODE = 8;
+    static constexpr int MAX_PROBES = 32;
+    
+private:
+    double exploration;
+    double rave_equivalence;
+    uint64_t seed;
+    size_t node_capacity;
+    size_t edge_capacity;
+    std::unique_ptr<Node[]> nodes;
+    std::unique_ptr<Edge[]> edges;
+    std::atomic<size_t> nodes_used{0};
+    std::atomic<size_t> edges_used{0};
+    WorkerPool pool;
+    
+    uint64_t searches = 0;
+    std::atomic<uint64_t> playouts{0};
+    uint32_t root = 0;
+    uint32_t reused_visits = 0;
+    
+    static uint64_t cell_key(int square, int player, int value) {
+        return mix64((static_cast<uint64_t>(square) << 24) | (player << 16) | value);
+    }
+    
+    static uint64_t side_key(int to_move) {
+        return mix64(0xC0FFEEULL + static_cast<uint64_t>(to_move));
+    }
+    
+    static uint64_t board_key(const BoardState& board) {
+        uint64_t key = mix64(static_cast<uint64_t>(board.size) << 40);
+        Bitboard occupied = board.occupancy[0];
+        while (occupied) {
+            int sq = pop_lsb(occupied);
+            int cell = (&board.board[0][0])[sq];
+            key ^= cell_key(sq, cell / 100, cell % 100);
+        }
+        return key;
+    }
+    
+    // Node of a position key, inserted if new; null when the table is full
+    Node* find(uint64_t key, uint32_t& index) {
+        key = key ? key : 1;
+        size_t mask = node_capacity - 1;
+        size_t i = key & mask;
+        for (int probe = 0; probe < MAX_PROBES; ++probe, i = (i + 1) & mask) {
+            uint64_t found = nodes[i].key.load(std::memory_order_acquire);
+            if (found == 0) {
+                if (nodes_used.load(std::memory_order_relaxed) * 4 >= node_capacity * 3) {
+                    return nullptr;
+                }
+                if (nodes[i].key.compare_exchange_strong(found, key, std::memory_order_acq_rel)) {
+                    nodes_used.fetch_add(1, std::memory_order_relaxed);
+                    index = static_cast<uint32_t>(i);
+                    return &nodes[i];
+                }
+            }
+            if (found == key) {
+                index = static_cast<uint32_t>(i);
+                return &nodes[i];
+            }
+        }
+        return nullptr;
+    }
+    
+    // Claim a node for expansion and publish its edges; false if another
+    // thread is expanding it or the edge arena is full
+    bool expand(Node& node, const BoardState& board, int to_move) {
+        uint8_t expected = UNEXPANDED;
+        if (!node.state.compare_exchange_strong(expected, EXPANDING,
+                                                std::memory_order_acquire)) {
+            return false;
+        }
+        node.to_move = static_cast<int8_t>(to_move);
+        node.num_edges = 0;
+        if (!to_move) {
+            node.proven.store(static_cast<int8_t>(MctsEngine::winner(board)),
+                              std::memory_order_relaxed);
+        } else {
+            auto moves = SearchEngine::generate_moves(board, to_move);
+            size_t first = edges_used.fetch_add(moves.size(), std::memory_order_relaxed);
+            if (first + moves.size() > edge_capacity) {
+                node.state.store(UNEXPANDED, std::memory_order_release);
+                return false;
+            }
+            node.first_edge = static_cast<uint32_t>(first);
+            node.num_edges = static_cast<uint16_t>(moves.size());
+            node.edge_squares = 0;
+            for (size_t i = 0; i < moves.size(); ++i) {
+                edges[first + i].move = moves[i];
+                node.edge_squares |= square_bit(moves[i].row * MAX_BOARD_SIZE + moves[i].col);
+            }
+        }
+        node.state.store(EXPANDED, std::memory_order_release);
+        return true;
+    }
+    
+    // Mean of a move for the player choosing it, from the shared child node
+    // once it has visits, otherwise from the edge
+    double mean(const Edge& edge, int player, uint32_t& visits) const {
+        uint32_t child = edge.child.load(std::memory_order_relaxed);
+        if (child) {
+            const Node& node = nodes[child - 1];
+            visits = node.visits.load(std::memory_order_relaxed);
+            if (visits) {
+                double a = node.wins_a.load(std::memory_order_relaxed) / (2.0 * visits);
+                return player == PLAYER_A ? a : 1.0 - a;
+            }
+        }
+        visits = edge.visits.load(std::memory_order_relaxed);
+        return visits ? edge.wins.load(std::memory_order_relaxed) / (2.0 * visits) : 0.0;
+    }
+    
+    int child_proven(const Edge& edge) const {
+        uint32_t child = edge.child.load(std::memory_order_relaxed);
+        return child ? nodes[child - 1].proven.load(std::memory_order_relaxed)
+                     : MctsEngine::UNPROVEN;
+    }
+    
+    // Best unproven edge, or null if every child is proven
+    Edge* select(const Node& node) const {
+        double log_visits = std::log(node.visits.load(std::memory_order_relaxed) + 1.0);
+        Edge* best = nullptr;
+        double best_score = -1.0;
+        for (uint32_t i = node.first_edge; i < node.first_edge + node.num_edges; ++i) {
+            Edge& edge = edges[i];
+            if (child_proven(edge) != MctsEngine::UNPROVEN) {
+                continue;
+            }
+            uint32_t edge_visits = edge.visits.load(std::memory_order_relaxed);
+            uint32_t amaf_visits = edge.amaf_visits.load(std::memory_order_relaxed);
+            if (edge_visits == 0 && (amaf_visits == 0 || rave_equivalence == 0.0)) {
+                return &edge;
+            }
+            uint32_t visits;
+            double q = mean(edge, node.to_move, visits);
+            double score = MctsEngine::uct_score(
+                q * visits, visits, edge.amaf_wins.load(std::memory_order_relaxed) / 2.0,
+                amaf_visits, log_visits, 0.0, rave_equivalence);
+            score += exploration * std::sqrt(log_visits / (edge_visits + 1.0));
+            if (score > best_score) {
+                best_score = score;
+                best = &edge;
+            }
+        }
+        return best;
+    }
+    
+    bool prove(Node& node) {
+        if (node.proven.load(std::memory_order_relaxed) != MctsEngine::UNPROVEN ||
+            node.state.load(std::memory_order_acquire) != EXPANDED || !node.num_edges) {
+            return false;
+        }
+        bool all = true, tie = false;
+        for (uint32_t i = node.first_edge; i < node.first_edge + node.num_edges; ++i) {
+            int outcome = child_proven(edges[i]);
+            if (outcome == node.to_move) {
+                node.proven.store(static_cast<int8_t>(outcome), std::memory_order_relaxed);
+                return true;
+            }
+            all = all && outcome != MctsEngine::UNPROVEN;
+            tie = tie || outcome == 0;
+        }
+        if (all) {
+            node.proven.store(static_cast<int8_t>(tie ? 0 : 3 - node.to_move),
+                              std::memory_order_relaxed);
+        }
+        return all;
+    }
+    
+    struct Step {
+        Node* node;
+        Edge* edge;  // taken from node, or null at the leaf
+    };
+    
+    void iterate(const BoardState& root_board, int root_player, std::mt19937_64& rng,
+                 RegionTracker& regions, std::vector<Step>& path) {
+        BoardState board = root_board;
+        uint64_t cells = board_key(board);
+        Node* node = &nodes[root];
+        int to_move = root_player;
+        int winner = MctsEngine::UNPROVEN;
+        path.clear();
+        
+        while (true) {
+            path.push_back({node, nullptr});
+            winner = node->proven.load(std::memory_order_relaxed);
+            if (winner != MctsEngine::UNPROVEN) {
+                break;
+            }
+            uint8_t state = node->state.load(std::memory_order_acquire);
+            if (state == UNEXPANDED) {
+                if (node->visits.load(std::memory_order_relaxed) == 0 && node != &nodes[root]) {
+                    winner = MctsEngine::resolve(board, to_move, regions);
+                    if (winner != MctsEngine::UNPROVEN) {
+                        node->proven.store(static_cast<int8_t>(winner), std::memory_order_relaxed);
                     }
+                    break;
+                }
+                if (!expand(*node, board, to_move)) {
+                    break;
+                }
+                winner = node->proven.load(std::memory_order_relaxed);
+                if (winner != MctsEngine::UNPROVEN) {
+                    break;
                 }
+            } else if (state == EXPANDING) {
+                break;
             }
+            
+            Edge* edge = select(*node);
+            if (!edge) {
+                prove(*node);
+                winner = node->proven.load(std::memory_order_relaxed);
+                break;
+            }
+            const Move& move = edge->move;
+            int sq = move.row * MAX_BOARD_SIZE + move.col;
+            if (board.board[move.row][move.col] ||
+                SearchEngine::move_value(board, sq, to_move) != move.value) {
+                break;  // key collision: the edge does not fit this board
+            }
+            edge->visits.fetch_add(1, std::memory_order_relaxed);
+            path.back().edge = edge;
+            SearchEngine::make_move(board, move, to_move);
+            cells ^= cell_key(sq, to_move, move.value);
+            to_move = MctsEngine::next_to_move(board, to_move);
+            
+            uint32_t child = edge->child.load(std::memory_order_relaxed);
+            if (!child) {
+                uint32_t index;
+                if (!find(cells ^ side_key(to_move), index)) {
+                    break;  // table full: play out below the edge
+                }
+                child = index + 1;
+                edge->child.store(child, std::memory_order_relaxed);
+            }
+            node = &nodes[child - 1];
         }
         
-        // Run search
+        Bitboard played[3] = {0, 0, 0};
+        if (winner == MctsEngine::UNPROVEN) {
+            winner = MctsEngine::playout(board, to_move, played, rng);
+        }
+        playouts.fetch_add(1, std::memory_order_relaxed);
+        
+        uint32_t result_a = winner == PLAYER_A ? 2 : winner == 0 ? 1 : 0;
+        for (size_t i = path.size(); i-- > 0;) {
+            Node& step = *path[i].node;
+            step.visits.fetch_add(1, std::memory_order_relaxed);
+            step.wins_a.fetch_add(result_a, std::memory_order_relaxed);
+            if (step.state.load(std::memory_order_acquire) != EXPANDED || !step.num_edges) {
+                continue;
+            }
+            uint32_t reward = winner == step.to_move ? 2 : winner == 0 ? 1 : 0;
+            if (Edge* edge = path[i].edge) {
+                edge->wins.fetch_add(reward, std::memory_order_relaxed);
+            }
+            Bitboard hits = played[step.to_move] & step.edge_squares;
+            while (hits) {
+                Bitboard bit = square_bit(pop_lsb(hits));
+                Edge& edge = edges[step.first_edge + popcount(step.edge_squares & (bit - 1))];
+                edge.amaf_visits.fetch_add(1, std::memory_order_relaxed);
+                edge.amaf_wins.fetch_add(reward, std::memory_order_relaxed);
+            }
+            if (path[i].edge) {
+                const Move& move = path[i].edge->move;
+                played[step.to_move] |= square_bit(move.row * MAX_BOARD_SIZE + move.col);
+            }
+        }
+        
+        for (size_t i = path.size() - 1; i-- > 0;) {
+            if (!prove(*path[i].node)) {
+                break;
+            }
+        }
+    }
+    
+    // Proven win for the root player, else the most visited unproven move
+    // unless a proven tie beats its mean, else anything left
+    const Edge* best_edge() const {
+        const Node& node = nodes[root];
+        int player = node.to_move;
+        const Edge* tie = nullptr;
+        const Edge* visited = nullptr;
+        for (uint32_t i = node.first_edge; i < node.first_edge + node.num_edges; ++i) {
+            const Edge& edge = edges[i];
+            int outcome = child_proven(edge);
+            if (outcome == player) {
+                return &edge;
+            }
+            if (outcome == 0 && !tie) {
+                tie = &edge;
+            } else if (outcome == MctsEngine::UNPROVEN &&
+                       (!visited || edge.visits.load() > visited->visits.load())) {
+                visited = &edge;
+            }
+        }
+        if (visited && tie) {
+            uint32_t visits;
+            return mean(*visited, player, visits) >= 0.5 ? visited : tie;
+        }
+        return visited ? visited : tie ? tie : &edges[node.first_edge];
+    }
+    
+public:
+    TranspositionMcts(size_t memory_mb = 64, int threads = 1, double exploration_constant = 0.4,
+                      double rave_k = 1000.0, uint64_t rng_seed = 0)
+        : exploration(exploration_constant), rave_equivalence(rave_k), seed(rng_seed),
+          pool(threads) {
+        if (exploration < 0.0 || rave_equivalence < 0.0) {
+            throw std::invalid_argument("exploration and rave_equivalence must be non-negative");
+        }
+        size_t slots = (memory_mb << 20) / (sizeof(Node) + EDGES_PER_NODE * sizeof(Edge));
+        node_capacity = 1024;
+        while (node_capacity * 2 <= slots) node_capacity <<= 1;
+        edge_capacity = node_capacity * EDGES_PER_NODE;
+        clear();
+    }
+    
+    void clear() {
+        nodes.reset(new Node[node_capacity]);
+        edges.reset(new Edge[edge_capacity]);
+        nodes_used = 0;
+        edges_used = 0;
+    }
+    
+    // Search from the stored graph until the playout or time limit (0 = none;
+    // at least one must be set) or the root is proven
+    Move search(const BoardState& board, int player, uint64_t max_playouts, double time_ms) {
+        if (board.num_players != 2) {
+            throw std::invalid_argument("MCTS supports two players");
+        }
+        if (!max_playouts && time_ms <= 0.0) {
+            throw std::invalid_argument("set a playout or time limit");
+        }
+        playouts = 0;
+        if (SearchEngine::generate_moves(board, player).empty()) {
+            return Move();
+        }
+        if (nodes_used.load() * 4 >= node_capacity * 3 ||
+            edges_used.load() * 4 >= edge_capacity * 3) {
+            clear();
+        }
+        uint64_t key = board_key(board) ^ side_key(player);
+        Node* root_node = find(key, root);
+        if (!root_node) {
+            clear();
+            root_node = find(key, root);
+        }
+        reused_visits = root_node->visits.load();
+        if (root_node->state.load() == UNEXPANDED && !expand(*root_node, board, player)) {
+            clear();
+            root_node = find(key, root);
+            expand(*root_node, board, player);
+        }
+        
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::microseconds(static_cast<int64_t>(time_ms * 1000.0));
+        uint64_t run = searches++;
+        pool.run([&](int worker, int) {
+            std::mt19937_64 rng(seed ^ mix64(run * 1024 + worker));
+            RegionTracker regions;
+            std::vector<Step> path;
+            uint64_t local = 0;
+            while (root_node->proven.load(std::memory_order_relaxed) == MctsEngine::UNPROVEN) {
+                if (max_playouts && playouts.load(std::memory_order_relaxed) >= max_playouts) {
+                    break;
+                }
+                if (time_ms > 0.0 && (local++ & 63) == 0 &&
+                    std::chrono::steady_clock::now() >= deadline) {
+                    break;
+                }
+                iterate(board, player, rng, regions, path);
+            }
+        });
+        return best_edge()->move;
+    }
+    
+    // Python interface: (row, col, value, playouts)
+    py::tuple find_best_move(py::list board_2d, int board_size, int player,
+                             uint64_t max_playouts, double time_ms) {
+        BoardState board = SearchEngine::load_board(board_2d, board_size, 2);
         Move best_move;
-        minimax(board, depth, 
-                std::numeric_limits<int>::min(), 
-                std::numeric_limits<int>::max(), 
-                true, player, best_move);
+        {
+            py::gil_scoped_release release;
+            best_move = search(board, player, max_playouts, time_ms);
+        }
+        return py::make_tuple(best_move.row, best_move.col, best_move.value, playouts.load());
+    }
+    
+    // Root moves of the last search as (row, col, value, visits, mean,
+    // amaf visits, amaf mean, proven winner or -1); visits are the edge's,
+    // the mean is the shared child node's
+    std::vector<py::tuple> get_root_stats() const {
+        std::vector<py::tuple> stats;
+        const Node& node = nodes[root];
+        if (node.state.load() != EXPANDED) {
+            return stats;
+        }
+        for (uint32_t i = node.first_edge; i < node.first_edge + node.num_edges; ++i) {
+            const Edge& edge = edges[i];
+            uint32_t visits, amaf_visits = edge.amaf_visits.load();
+            double q = mean(edge, node.to_move, visits);
+            stats.push_back(py::make_tuple(
+                edge.move.row, edge.move.col, edge.move.value, edge.visits.load(), q,
+                amaf_visits, amaf_visits ? edge.amaf_wins.load() / (2.0 * amaf_visits) : 0.0,
+                child_proven(edge)));
+        }
+        return stats;
+    }
+    
+    int get_proven() const {
+        return nodes[root].proven.load();
+    }
+    
+    // Occupancy of the node table and edge arena, and the root visits
+    // carried over from earlier searches
+    py::dict get_table_stats() const {
+        py::dict stats;
+        stats["nodes"] = nodes_used.load();
+        stats["node_capacity"] = node_capacity;
+        stats["edges"] = std::min(edges_used.load(), edge_capacity);
+        stats["edge_capacity"] = edge_capacity;
+        stats["memory_bytes"] = node_capacity * sizeof(Node) + edge_capacity * sizeof(Edge);
+        stats["reused_root_visits"] = reused_visits;
+        stats["threads"] = pool.size();
+        return stats;
+    }
+};
+
+// Declared tunable parameters as (name, default, min, max, step)
+std::vector<py::tuple> tunable_params() {
+    SearchParams defaults;
+    std::vector<py::tuple> result;
+    for (const auto& spec : SearchParams::specs()) {
+        result.push_back(py::make_tuple(spec.name, defaults.*spec.field, spec.min, spec.max,
+                                        spec.step));
+    }
+    return result;
+}
+
+// Per-position engine selection. Each position is classified (board size,
+// players, empty cells, branching factor, region separation) and handed to
+// the first registered engine that is adequate for it; an engine may also
+// decline a position at search time (e.g. the solver running out of
+// budget), and the next one gets it. Engines are registered most
+// specialised first. Every decision is counted in the stats.
+class Dispatcher {
+public:
+    struct Position {
+        int board_size;
+        int num_players;
+        int player;
+        int depth;
+        double time_ms;
+        uint64_t node_limit;
+        int threads;
+        int empty_cells;
+        int branching;       // legal moves of the player to move
+        bool separated;      // no empty region reachable by two players
+        BoardState board;    // boards up to MAX_BOARD_SIZE
+        std::vector<std::array<int, 4>> cells;  // occupied cells, larger boards
+    };
+    
+    struct Engine {
+        std::string name;
+        std::function<bool(const Position&)> adequate;
+        // Returns false to decline the position; nodes is set on success
+        std::function<bool(Position&, Move&, uint64_t&)> search;
+        uint64_t calls = 0;
+        uint64_t declined = 0;
+        uint64_t nodes = 0;
+        double seconds = 0.0;
+    };
+    
+    // Work limit for the exact solver before it hands over to alpha-beta
+    static constexpr uint64_t SOLVER_BUDGET = 1 << 20;
+    
+    // Open positions on large boards branch too widely for alpha-beta to see
+    // far, and go to MCTS instead; without a time or node limit it runs
+    // MCTS_PLAYOUTS playouts
+    static constexpr int MCTS_MIN_BOARD_SIZE = 9;
+    static constexpr int MCTS_MIN_BRANCHING = 24;
+    static constexpr uint64_t MCTS_PLAYOUTS = 1 << 14;
+    
+    // The sparse engine only serves boards above MAX_BOARD_SIZE, so its table
+    // is allocated on first use and kept small
+    static constexpr size_t SPARSE_TT_SIZE = 1 << 16;
+    
+private:
+    SearchEngine& engine;
+    std::unique_ptr<SparseEngine> sparse;
+    std::unique_ptr<MctsEngine> mcts;
+    std::vector<Engine> engines;
+    std::string last_engine;
+    Position last;
+    
+    void classify(Position& pos) const {
+        if (pos.board_size > MAX_BOARD_SIZE) {
+            pos.empty_cells = pos.board_size * pos.board_size - static_cast<int>(pos.cells.size());
+            pos.branching = -1;  // left to the sparse engine
+            pos.separated = false;
+            return;
+        }
+        const BoardMasks& masks = board_masks(pos.board_size);
+        pos.empty_cells = popcount(masks.full & ~pos.board.occupancy[0]);
+        pos.branching = engine.count_mobility(pos.board, pos.player);
+        RegionTracker regions;
+        regions.reset(pos.board);
+        pos.separated = regions.separated();
+    }
+    
+public:
+    explicit Dispatcher(SearchEngine& search_engine) : engine(search_engine) {
+        register_engine({"sparse",
+            [](const Position& pos) {
+                return pos.board_size > MAX_BOARD_SIZE && pos.num_players == 2;
+            },
+            [this](Position& pos, Move& move, uint64_t& nodes) {
+                if (!sparse) {
+                    sparse = std::make_unique<SparseEngine>(
+                        std::min(engine.get_tt_size(), SPARSE_TT_SIZE));
+                }
+                if (sparse->get_params() != engine.get_params()) {
+                    sparse->set_params(engine.get_params());
+                }
+                sparse->load(pos.cells, pos.board_size);
+                move = sparse->search(pos.player, pos.depth, pos.node_limit);
+                nodes = sparse->get_nodes();
+                return true;
+            }});
+        register_engine({"book",
+            [this](const Position& pos) {
+                return pos.board_size <= MAX_BOARD_SIZE && pos.num_players == 2 &&
+                       engine.book.is_open();
+            },
+            [this](Position& pos, Move& move, uint64_t& nodes) {
+                nodes = 0;
+                if (!engine.probe_book(pos.board, pos.player, move)) {
+                    return false;
+                }
+                engine.book_hits++;
+                return true;
+            }});
+        register_engine({"solver",
+            [](const Position& pos) {
+                return pos.board_size <= MAX_BOARD_SIZE && pos.separated && pos.branching > 0;
+            },
+            [this](Position& pos, Move& move, uint64_t& nodes) {
+                auto moves = engine.generate_moves(pos.board, pos.player);
+                std::sort(moves.begin(), moves.end(),
+                          [](const Move& a, const Move& b) { return a.value > b.value; });
+                ChainSolver solver(pos.board_size, SOLVER_BUDGET);
+                int final_max;
+                bool solved = solver.solve(pos.board, pos.player, moves, final_max, move);
+                nodes = solver.get_nodes();
+                return solved;
+            }});
+        register_engine({"mcts",
+            [](const Position& pos) {
+                return pos.board_size >= MCTS_MIN_BOARD_SIZE &&
+                       pos.board_size <= MAX_BOARD_SIZE && pos.num_players == 2 &&
+                       !pos.separated && pos.branching >= MCTS_MIN_BRANCHING;
+            },
+            [this](Position& pos, Move& move, uint64_t& nodes) {
+                if (!mcts) {
+                    mcts = std::make_unique<MctsEngine>();
+                }
+                uint64_t playouts = pos.node_limit ? pos.node_limit
+                                  : pos.time_ms > 0.0 ? 0 : MCTS_PLAYOUTS;
+                move = mcts->search(pos.board, pos.player, playouts, pos.time_ms);
+                nodes = mcts->get_playouts();
+                return true;
+            }});
+        register_engine({"alphabeta",
+            [](const Position& pos) { return pos.board_size <= MAX_BOARD_SIZE; },
+            [this](Position& pos, Move& move, uint64_t& nodes) {
+                nodes = engine.parallel_search(pos.board, pos.player, pos.depth, pos.node_limit,
+                                               pos.threads, move, pos.time_ms);
+                return true;
+            }});
+    }
+    
+    // Add an engine. It goes before the alpha-beta fallback, which stays last.
+    void register_engine(Engine entry) {
+        if (!engines.empty() && engines.back().name == "alphabeta") {
+            engines.insert(engines.end() - 1, std::move(entry));
+        } else {
+            engines.push_back(std::move(entry));
+        }
+    }
+    
+    // Python interface: (row, col, value, nodes, engine name)
+    py::tuple find_best_move(py::list board_2d, int board_size, int player, int depth,
+                             double time_ms, int num_players, uint64_t node_limit, int threads) {
+        Position pos{};
+        pos.board_size = board_size;
+        pos.num_players = num_players;
+        pos.player = player;
+        pos.depth = depth;
+        pos.time_ms = time_ms;
+        pos.node_limit = node_limit;
+        pos.threads = threads;
+        if (player < 1 || player > num_players) {
+            throw std::invalid_argument("player out of range: " + std::to_string(player));
+        }
+        SearchEngine::check_threads(threads, node_limit);
+        if (board_size > MAX_BOARD_SIZE) {
+            for (int i = 0; i < board_size; ++i) {
+                py::list row = board_2d[i];
+                for (int j = 0; j < board_size; ++j) {
+                    py::object cell = row[j];
+                    if (!cell.is_none()) {
+                        py::tuple cell_tuple = cell.cast<py::tuple>();
+                        pos.cells.push_back({i, j, cell_tuple[0].cast<int>(),
+                                             cell_tuple[1].cast<int>()});
+                    }
+                }
+            }
+        } else {
+            pos.board = SearchEngine::load_board(board_2d, board_size, num_players);
+        }
+        engine.check_memory_pressure();
         
-        // Return (row, col, value, nodes_evaluated)
-        return py::make_tuple(best_move.row, best_move.col, best_move.value, nodes_evaluated);
+        Move best_move;
+        uint64_t nodes = 0;
+        std::string chosen;
+        {
+            py::gil_scoped_release release;
+            classify(pos);
+            for (auto& candidate : engines) {
+                if (!candidate.adequate(pos)) continue;
+                auto start = std::chrono::steady_clock::now();
+                bool accepted = candidate.search(pos, best_move, nodes);
+                candidate.seconds += std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start).count();
+                if (!accepted) {
+                    candidate.declined++;
+                    continue;
+                }
+                candidate.calls++;
+                candidate.nodes += nodes;
+                chosen = candidate.name;
+                break;
+            }
+        }
+        if (chosen.empty()) {
+            throw std::invalid_argument("no engine can search this position");
+        }
+        last = pos;
+        last_engine = chosen;
+        engine.nodes_evaluated = nodes;
+        return py::make_tuple(best_move.row, best_move.col, best_move.value, nodes, chosen);
     }
     
-    void clear_tt() {
-        tt.clear();
+    // {engine: {"calls", "declined", "nodes", "seconds"}}
+    py::dict get_stats() const {
+        py::dict stats;
+        for (const auto& entry : engines) {
+            py::dict item;
+            item["calls"] = entry.calls;
+            item["declined"] = entry.declined;
+            item["nodes"] = entry.nodes;
+            item["seconds"] = entry.seconds;
+            stats[entry.name.c_str()] = item;
+        }
+        return stats;
     }
     
-    int get_nodes_evaluated() const {
-        return nodes_evaluated;
+    // Features of the last position and the engine chosen for it
+    py::dict get_last_decision() const {
+        py::dict decision;
+        decision["engine"] = last_engine;
+        decision["board_size"] = last.board_size;
+        decision["num_players"] = last.num_players;
+        decision["empty_cells"] = last.empty_cells;
+        decision["branching"] = last.branching;
+        decision["separated"] = last.separated;
+        decision["time_ms"] = last.time_ms;
+        return decision;
+    }
+    
+    std::vector<std::string> engine_names() const {
+        std::vector<std::string> names;
+        for (const auto& entry : engines) {
+            names.push_back(entry.name);
+        }
+        return names;
     }
 };
 
+// Replay a request log against fresh engines and report throughput and
+// latency. speed 0 runs the requests back to back as fast as possible;
+// otherwise they arrive at the recorded times scaled by 1 / speed, and a
+// request's latency includes any time it waited for a free worker. Each
+// worker owns an engine, like one server process.
+py::dict replay_requests(const std::string& path, double speed, int workers, size_t tt_size) {
+    if (speed < 0.0) {
+        throw std::invalid_argument("speed must not be negative");
+    }
+    std::vector<RequestLog::Request> requests = RequestLog::load(path);
+    workers = std::max(1, workers);
+    
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> latencies(requests.size());
+    std::atomic<size_t> next(0);
+    std::atomic<uint64_t> total_nodes(0);
+    double elapsed = 0.0;
+    {
+        py::gil_scoped_release release;
+        std::vector<std::unique_ptr<SearchEngine>> engines;
+        for (int i = 0; i < workers; ++i) {
+            engines.emplace_back(new SearchEngine(tt_size));
+        }
+        
+        Clock::time_point start = Clock::now();
+        uint64_t first_arrival = requests.empty() ? 0 : requests[0].header.arrival_us;
+        auto worker = [&](int index) {
+            SearchEngine& engine = *engines[index];
+            for (size_t i = next++; i < requests.size(); i = next++) {
+                const RequestLog::Request& request = requests[i];
+                Clock::time_point arrival = Clock::now();
+                if (speed > 0.0) {
+                    double offset = (request.header.arrival_us - first_arrival) / speed;
+                    arrival = start + std::chrono::microseconds(static_cast<int64_t>(offset));
+                    std::this_thread::sleep_until(arrival);
+                }
+                engine.replay_request(request);
+                total_nodes += engine.get_nodes_evaluated();
+                latencies[i] = std::chrono::duration<double>(Clock::now() - arrival).count();
+            }
+        };
+        std::vector<std::thread> threads;
+        for (int i = 1; i < workers; ++i) {
+            threads.emplace_back(worker, i);
+        }
+        worker(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    
+    // Latency summary in milliseconds (nearest-rank percentiles)
+    std::vector<double> ordered(latencies);
+    std::sort(ordered.begin(), ordered.end());
+    py::dict latency;
+    latency["count"] = ordered.size();
+    if (!ordered.empty()) {
+        auto rank = [&](double p) {
+            return ordered[std::min(ordered.size() - 1, static_cast<size_t>(p / 100 * ordered.size()))] * 1000;
+        };
+        double sum = 0.0;
+        for (double seconds : ordered) sum += seconds;
+        latency["mean"] = sum / ordered.size() * 1000;
+        latency["p50"] = rank(50);
+        latency["p90"] = rank(90);
+        latency["p99"] = rank(99);
+        latency["max"] = ordered.back() * 1000;
+    }
+    
+    py::dict report;
+    report["requests"] = requests.size();
+    report["workers"] = workers;
+    report["speed"] = speed;
+    report["seconds"] = elapsed;
+    report["requests_per_second"] = elapsed > 0 ? requests.size() / elapsed : 0.0;
+    report["nodes"] = total_nodes.load();
+    report["nodes_per_second"] = elapsed > 0 ? total_nodes.load() / elapsed : 0.0;
+    report["latency_ms"] = latency;
+    return report;
+}
+
 // Python bindings
 PYBIND11_MODULE(search_engine, m) {
     m.doc() = "Fast C++ search engine for Sequencium game";
     
     py::class_<SearchEngine>(m, "SearchEngine")
-        .def(py::init<>())
+        .def(py::init<size_t, double>(),
+             py::arg("tt_size") = 1048576, py::arg("tt_memory_fraction") = 0.0)
         .def("find_best_move", &SearchEngine::find_best_move,
-             "Find the best move using minimax with alpha-beta pruning",
-             py::arg("board"), py::arg("board_size"), py::arg("player"), py::arg("depth"))
+             "Find the best move using iterative deepening alpha-beta, optionally "
+             "limited to a node budget and searched with several threads",
+             py::arg("board"), py::arg("board_size"), py::arg("player"), py::arg("depth"),
+             py::arg("nodes") = 0, py::arg("threads") = 1)
+        .def("find_best_move_multi", &SearchEngine::find_best_move_multi,
+             "Find the best move for one of 2-4 players using paranoid alpha-beta or max^n",
+             py::arg("board"), py::arg("board_size"), py::arg("player"), py::arg("depth"),
+             py::arg("num_players"), py::arg("mode") = "paranoid")
         .def("clear_tt", &SearchEngine::clear_tt,
              "Clear the transposition table")
+        .def("set_verified", &SearchEngine::set_verified,
+             "Key the transposition table by exact positions on boards up to 6x6, "
+             "ruling out hash collisions when solving",
+             py::arg("enable") = true, py::arg("entries") = 1 << 20)
+        .def("is_verified", &SearchEngine::is_verified,
+             "Whether exact position keys are in use")
+        .def("set_lazy_eval", &SearchEngine::set_lazy_eval,
+             "Stop evaluating a leaf once its max value gap puts it outside the "
+             "search window (on by default)",
+             py::arg("enable") = true)
+        .def("is_lazy_eval", &SearchEngine::is_lazy_eval,
+             "Whether leaf evaluation exits early on a decided score")
+        .def("set_root_driver", &SearchEngine::set_root_driver,
+             "Search each iteration with full-window 'alphabeta' or with 'mtdf' "
+             "zero-window searches converging from the previous iteration's value",
+             py::arg("driver") = "alphabeta")
+        .def("get_root_driver", &SearchEngine::get_root_driver,
+             "The iterative deepening root driver in use")
         .def("get_nodes_evaluated", &SearchEngine::get_nodes_evaluated,
-             "Get the number of nodes evaluated in last search");
+             "Get the number of nodes evaluated in last search")
+        .def("get_tt_size", &SearchEngine::get_tt_size,
+             "Get the number of transposition table entries")
+        .def("rehash_tt", &SearchEngine::rehash_tt,
+             "Resize the transposition table, keeping its entries", py::arg("entries"))
+        .def("get_search_stats", &SearchEngine::get_search_stats,
+             "Get thread, node and transposition table counters of the last search")
+        .def("evaluate_batch", &SearchEngine::evaluate_batch,
+             "Static evaluation terms of stacked positions: (n, 2, size, size) owner "
+             "and value planes in, (n, 5) max/cell/mobility/territory differences "
+             "and weighted score out",
+             py::arg("boards"), py::arg("players"), py::arg("threads") = 0)
+        .def("set_numa_policy", &SearchEngine::set_numa_policy,
+             "Place the transposition table 'local' or 'interleave'd over NUMA nodes, "
+             "and optionally pin search threads to nodes round-robin",
+             py::arg("placement") = "local", py::arg("pin_threads") = false)
+        .def("get_numa_policy", &SearchEngine::get_numa_policy,
+             "Get the NUMA node count, whether the table is interleaved, and pinning")
+        .def("collect_cutoff_stats", &SearchEngine::collect_cutoff_stats,
+             "Start or stop gathering cutoff statistics for learned move ordering",
+             py::arg("enable") = true)
+        .def("get_cutoff_stats", &SearchEngine::get_cutoff_stats,
+             "Get (cutoff nodes, first-move cutoffs) since collection began")
+        .def("save_ordering_tables", &SearchEngine::save_ordering_tables,
+             "Write move-ordering tables built from the collected statistics",
+             py::arg("path"))
+        .def("load_ordering_tables", &SearchEngine::load_ordering_tables,
+             "Load move-ordering tables used as prior scores by move ordering",
+             py::arg("path"))
+        .def("open_experience_book", &SearchEngine::open_experience_book,
+             "Open or create a memory-mapped experience book",
+             py::arg("path"), py::arg("min_visits") = 16, py::arg("capacity") = 1 << 20)
+        .def("record_game", &SearchEngine::record_game,
+             "Append a finished game of (player, row, col, value) moves to the experience log",
+             py::arg("board_size"), py::arg("moves"), py::arg("merge") = true)
+        .def("merge_experience_log", &SearchEngine::merge_experience_log,
+             "Merge the experience log into the book, returning the records merged")
+        .def("get_book_stats", &SearchEngine::get_book_stats,
+             "Get (entries, capacity, book hits) of the experience book")
+        .def("load_params", &SearchEngine::load_params,
+             "Load search parameters from a file written by tune_spsa.py",
+             py::arg("path"))
+        .def("save_params", &SearchEngine::save_params,
+             "Write the current search parameters to a file",
+             py::arg("path"))
+        .def("set_params", &SearchEngine::set_params,
+             "Set search parameters from a {name: value} dict",
+             py::arg("params"))
+        .def("get_params", &SearchEngine::get_params,
+             "Get the search parameters as a {name: value} dict")
+        .def("start_recording", &SearchEngine::start_recording,
+             "Append every following search request to a binary log for replay",
+             py::arg("path"))
+        .def("stop_recording", &SearchEngine::stop_recording,
+             "Stop recording search requests")
+        .def("check_memory_pressure", &SearchEngine::check_memory_pressure,
+             "Shrink an auto-sized transposition table if cgroup memory pressure rose",
+             py::arg("force") = false);
+    
+    m.def("numa_nodes", &numa_node_cpus,
+          "CPUs of each NUMA node (one empty list if the topology is unknown)");
+    
+    m.def("build_region_db", &build_region_db,
+          "Enumerate every region shape up to max_cells cells, solve its longest "
+          "chains and write the region shape database to path",
+          py::arg("path"), py::arg("max_cells") = 9);
+    m.def("open_region_db", [](const std::string& path) { region_shapes().open(path); },
+          "Map a region shape database for the endgame chain solver (not while searching)",
+          py::arg("path"));
+    m.def("close_region_db", []() { region_shapes().close(); },
+          "Unmap the region shape database (not while searching)");
+    m.def("region_db_stats", &region_db_stats,
+          "Whether a region shape database is open, its max_cells and shape count");
+    
+    m.attr("MAX_BOARD_SIZE") = MAX_BOARD_SIZE;
+    m.attr("MAX_SPARSE_BOARD_SIZE") = MAX_SPARSE_BOARD_SIZE;
+    
+    py::class_<SparseEngine>(m, "SparseEngine")
+        .def(py::init<size_t>(), py::arg("tt_size") = 1048576)
+        .def("find_best_move", &SparseEngine::find_best_move,
+             "Find the best move on a large two-player board given its occupied "
+             "cells as (row, col, player, value); returns (row, col, value, nodes)",
+             py::arg("cells"), py::arg("board_size"), py::arg("player"), py::arg("depth"),
+             py::arg("nodes") = 0)
+        .def("frontier_size", &SparseEngine::frontier_size,
+             "Number of legal moves of a player in the last loaded position",
+             py::arg("player"))
+        .def("clear_tt", &SparseEngine::clear_tt,
+             "Clear the transposition table")
+        .def("set_params", &SparseEngine::set_params,
+             "Set evaluation weights from a {name: value} dict",
+             py::arg("params"))
+        .def("get_params", &SparseEngine::get_params,
+             "Get the evaluation weights as a {name: value} dict");
+    
+    py::class_<MctsEngine>(m, "MctsEngine")
+        .def(py::init<double, double, size_t, uint64_t>(),
+             py::arg("exploration") = 0.4, py::arg("rave_equivalence") = 1000.0,
+             py::arg("node_limit") = 1 << 20, py::arg("seed") = 0)
+        .def("find_best_move", &MctsEngine::find_best_move,
+             "Find the most visited move after Monte Carlo tree search with RAVE",
+             py::arg("board"), py::arg("board_size"), py::arg("player"),
+             py::arg("playouts") = 10000, py::arg("time_ms") = 0.0)
+        .def("get_root_stats", &MctsEngine::get_root_stats,
+             "Get (row, col, value, visits, mean, amaf visits, amaf mean, proven winner) "
+             "per root move")
+        .def("get_playouts", &MctsEngine::get_playouts,
+             "Get the number of playouts in the last search")
+        .def("get_proven", &MctsEngine::get_proven,
+             "Get the proven winner of the last root position (0 tie), or -1 if unsolved")
+        .def("tree_size", &MctsEngine::tree_size,
+             "Get the number of nodes in the last search tree");
+    
+    py::class_<TranspositionMcts>(m, "TranspositionMcts")
+        .def(py::init<size_t, int, double, double, uint64_t>(),
+             py::arg("memory_mb") = 64, py::arg("threads") = 1, py::arg("exploration") = 0.4,
+             py::arg("rave_equivalence") = 1000.0, py::arg("seed") = 0)
+        .def("find_best_move", &TranspositionMcts::find_best_move,
+             "Find the most visited move after Monte Carlo search over a shared "
+             "transposition graph, reusing what earlier searches stored",
+             py::arg("board"), py::arg("board_size"), py::arg("player"),
+             py::arg("playouts") = 10000, py::arg("time_ms") = 0.0)
+        .def("get_root_stats", &TranspositionMcts::get_root_stats,
+             "Get (row, col, value, visits, mean, amaf visits, amaf mean, proven winner) "
+             "per root move")
+        .def("get_proven", &TranspositionMcts::get_proven,
+             "Get the proven winner of the last root position (0 tie), or -1 if unsolved")
+        .def("get_table_stats", &TranspositionMcts::get_table_stats,
+             "Get node table and edge arena usage")
+        .def("clear", &TranspositionMcts::clear,
+             "Forget all stored positions");
+    
+    m.def("play_match", &play_match,
+          "Play a native self-play match between two parameter dicts; returns "
+          "(wins, losses, draws) for params_a",
+          py::arg("params_a"), py::arg("params_b"), py::arg("games") = 64,
+          py::arg("board_size") = 6, py::arg("depth") = 3, py::arg("nodes") = 0,
+          py::arg("random_plies") = 4, py::arg("threads") = 0, py::arg("seed") = 0);
+    py::class_<RegionMap>(m, "RegionTracker")
+        .def(py::init<py::list, int, int>(),
+             py::arg("board"), py::arg("board_size"), py::arg("num_players") = 2)
+        .def("make_move", &RegionMap::make_move,
+             "Fill a cell, updating the empty regions incrementally",
+             py::arg("row"), py::arg("col"), py::arg("player"), py::arg("value"))
+        .def("unmake_move", &RegionMap::unmake_move,
+             "Undo the last make_move")
+        .def("separated", &RegionMap::separated,
+             "True if no empty region can be reached by more than one player")
+        .def("region_of", &RegionMap::region_of,
+             "Region label of an empty cell (-1 if occupied)",
+             py::arg("row"), py::arg("col"))
+        .def("region_cells", &RegionMap::region_cells,
+             "Cells of the empty region containing a cell",
+             py::arg("row"), py::arg("col"))
+        .def("region_count", &RegionMap::region_count,
+             "Number of empty regions");
+    
+    py::class_<Dispatcher>(m, "Dispatcher")
+        .def(py::init<SearchEngine&>(), py::arg("engine"), py::keep_alive<1, 2>())
+        .def("find_best_move", &Dispatcher::find_best_move,
+             "Classify the position and search it with the best adequate engine; "
+             "returns (row, col, value, nodes, engine)",
+             py::arg("board"), py::arg("board_size"), py::arg("player"), py::arg("depth"),
+             py::arg("time_ms") = 0.0, py::arg("num_players") = 2, py::arg("nodes") = 0,
+             py::arg("threads") = 1)
+        .def("get_stats", &Dispatcher::get_stats,
+             "Per-engine calls, declined positions, nodes and seconds")
+        .def("get_last_decision", &Dispatcher::get_last_decision,
+             "Features of the last position and the engine chosen")
+        .def("engines", &Dispatcher::engine_names,
+             "Registered engines in the order they are consulted");
+    
+    m.def("analyse_archive", &analyse_archive,
+          "Analyse a game archive (one 'size p,r,c,v ...' game per line) with a "
+          "streaming reader/search-worker/writer pipeline into annotated JSON lines",
+          py::arg("input_path"), py::arg("output_path"), py::arg("depth") = 4,
+          py::arg("nodes") = 0, py::arg("workers") = 0, py::arg("queue_size") = 64,
+          py::arg("tt_size") = 65536);
+    m.def("tunable_params", &tunable_params,
+          "Declared search parameters as (name, default, min, max, step)");
+    
+    m.def("replay_requests", &replay_requests,
+          "Replay a request log and report throughput and latency; speed 0 runs "
+          "at full speed, otherwise at the recorded arrival rate times speed",
+          py::arg("path"), py::arg("speed") = 0.0, py::arg("workers") = 1,
+          py::arg("tt_size") = 1048576);
+    
+    py::class_<VectorEnv>(m, "VectorEnv")
+        .def(py::init<int, int, int, int>(),
+             py::arg("num_envs"), py::arg("board_size") = 6,
+             py::arg("opponent_depth") = 0, py::arg("threads") = 0)
+        .def("reset", &VectorEnv::reset,
+             "Reset all games; returns (observations, legal_masks)")
+        .def("step", &VectorEnv::step,
+             "Step all games with cell-index actions; returns "
+             "(observations, rewards, dones, legal_masks)",
+             py::arg("actions"))
+        .def_property_readonly("num_envs", &VectorEnv::get_num_envs)
+        .def_property_readonly("board_size", &VectorEnv::get_board_size)
+        .def_property_readonly_static("num_planes",
+             [](py::object) { return VectorEnv::NUM_PLANES; });
+    
+    py::class_<SearchScheduler>(m, "SearchScheduler")
+        .def(py::init<int, uint64_t, size_t>(),
+             py::arg("workers") = 0, py::arg("slice_nodes") = 256, py::arg("tt_size") = 1048576)
+        .def("submit", &SearchScheduler::submit,
+             "Queue a search; returns an id for wait()/poll()",
+             py::arg("board"), py::arg("board_size"), py::arg("player"), py::arg("depth"),
+             py::arg("time_ms") = 0, py::arg("nodes") = 0)
+        .def("wait", &SearchScheduler::wait,
+             "Wait for a search: (row, col, value, nodes, completed_depth) or None on timeout",
+             py::arg("id"), py::arg("timeout_ms") = -1)
+        .def("poll", &SearchScheduler::poll,
+             "Result of a finished search, or None if it is still running",
+             py::arg("id"))
+        .def("pending", &SearchScheduler::pending,
+             "Number of searches submitted but not yet collected");
 }
@@ -9,7 +9,9 @@ This implementation includes:
 - Command-line interface
 """
 
+import os
 import sys
+import time
 import logging
 from typing import List, Tuple, Optional, Set
 from copy import deepcopy
@@ -27,33 +29,67 @@ except ImportError:
     CPP_AVAILABLE = False
     cpp_engine = None
 
+# NumPy backs the vectorised fallback board (NumpyGameBoard) if installed
+try:
+    import numpy as np
+    NUMPY_AVAILABLE = True
+except ImportError:
+    NUMPY_AVAILABLE = False
+    np = None
+
+
+# Learned move-ordering tables written by train_ordering.py, loaded if present
+ORDERING_TABLES = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'ordering_tables.txt')
+# Search parameters tuned by tune_spsa.py, loaded if present
+SEARCH_PARAMS = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'search_params.txt')
+# Region shape database written by build_region_db.py, opened if present
+REGION_SHAPES = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'region_shapes.db')
+
 
 class Player(Enum):
     """Enumeration for players"""
     A = 1  # Player A (starts at top-left)
     B = 2  # Player B (starts at bottom-right)
+    C = 3  # Player C (starts at top-right, 3-4 player variant)
+    D = 4  # Player D (starts at bottom-left, 4 player variant)
 
 
 class GameBoard:
     """Represents the Sequencium game board"""
     
-    def __init__(self, size: int = 6):
+    def __init__(self, size: int = 6, num_players: int = 2):
         """
         Initialize the game board
         
         Args:
             size: Size of the square board (default 6x6)
+            num_players: Number of players, 2-4 (default 2)
         """
+        if not 2 <= num_players <= 4:
+            raise ValueError("num_players must be between 2 and 4")
+        
         self.size = size
+        self.num_players = num_players
+        self.players = list(Player)[:num_players]
         self.board = [[None for _ in range(size)] for _ in range(size)]
-        self.player_positions = {Player.A: set(), Player.B: set()}
-        
-        # Initialize starting positions
-        self.board[0][0] = (Player.A, 1)
-        self.player_positions[Player.A].add((0, 0))
+        self.player_positions = {player: set() for player in self.players}
+        self.history = []  # (player, row, col, value) for every move made
         
-        self.board[size-1][size-1] = (Player.B, 1)
-        self.player_positions[Player.B].add((size-1, size-1))
+        # Initialize starting positions (one corner per player)
+        for player in self.players:
+            row, col = self.corner(player)
+            self.board[row][col] = (player, 1)
+            self.player_positions[player].add((row, col))
+    
+    def corner(self, player: Player) -> Tuple[int, int]:
+        """Starting cell of a player"""
+        last = self.size - 1
+        return {Player.A: (0, 0), Player.B: (last, last),
+                Player.C: (0, last), Player.D: (last, 0)}[player]
+    
+    def next_player(self, player: Player) -> Player:
+        """Get the player whose turn follows the given player"""
+        return self.players[(self.players.index(player) + 1) % self.num_players]
     
     def get_cell(self, row: int, col: int) -> Optional[Tuple[Player, int]]:
         """Get the value at a cell"""
@@ -108,6 +144,14 @@ class GameBoard:
         
         return [(row, col, value) for (row, col), value in move_dict.items()]
     
+    def cell_count(self, player: Player) -> int:
+        """Number of cells a player owns"""
+        return len(self.player_positions[player])
+    
+    def mobility(self, player: Player) -> int:
+        """Number of valid moves (distinct empty cells) for a player"""
+        return len(self.get_valid_moves(player))
+    
     def make_move(self, row: int, col: int, player: Player, value: int) -> bool:
         """
         Make a move on the board
@@ -124,6 +168,7 @@ class GameBoard:
             return False
         
         self.set_cell(row, col, player, value)
+        self.history.append((player, row, col, value))
         return True
     
     def get_max_value(self, player: Player) -> int:
@@ -136,32 +181,58 @@ class GameBoard:
     
     def is_game_over(self) -> bool:
         """Check if the game is over"""
-        # Game is over if both players have no valid moves
-        return (len(self.get_valid_moves(Player.A)) == 0 and 
-                len(self.get_valid_moves(Player.B)) == 0)
+        # Game is over if no player has valid moves
+        return all(len(self.get_valid_moves(player)) == 0 for player in self.players)
     
     def get_winner(self) -> Optional[Player]:
         """
         Get the winner of the game
         
         Returns:
-            Player.A, Player.B, or None for tie
+            The player with the highest maximum value, or None for tie
         """
-        max_a = self.get_max_value(Player.A)
-        max_b = self.get_max_value(Player.B)
+        max_values = {player: self.get_max_value(player) for player in self.players}
+        best = max(max_values.values())
+        leaders = [player for player, value in max_values.items() if value == best]
         
-        if max_a > max_b:
-            return Player.A
-        elif max_b > max_a:
-            return Player.B
-        else:
-            return None
+        return leaders[0] if len(leaders) == 1 else None
+    
+    def to_record(self) -> str:
+        """
+        The game so far as one archive line, "size p,r,c,v ...", the format
+        search_engine.analyse_archive reads
+        """
+        moves = " ".join(f"{player.value},{row},{col},{value}"
+                         for player, row, col, value in self.history)
+        return f"{self.size} {moves}".rstrip()
+    
+    def to_engine_board(self):
+        """
+        The board as rows of None or (player number, value), the format the
+        C++ engines take
+        """
+        return [[None if cell is None else (cell[0].value, cell[1]) for cell in row]
+                for row in self.board]
+    
+    def to_planes(self):
+        """
+        The board as a (2, size, size) int32 NumPy array of owner (0 empty,
+        else the player's number) and value planes, the layout
+        SearchEngine.evaluate_batch takes when stacked
+        """
+        planes = np.zeros((2, self.size, self.size), dtype=np.int32)
+        for player, positions in self.player_positions.items():
+            for row, col in positions:
+                planes[0, row, col] = player.value
+                planes[1, row, col] = self.board[row][col][1]
+        return planes
     
     def copy(self):
         """Create a deep copy of the board"""
-        new_board = GameBoard(self.size)
+        new_board = GameBoard(self.size, self.num_players)
         new_board.board = deepcopy(self.board)
         new_board.player_positions = deepcopy(self.player_positions)
+        new_board.history = list(self.history)
         return new_board
     
     def __str__(self) -> str:
@@ -177,8 +248,7 @@ class GameBoard:
                     row_str += "  ."
                 else:
                     player, value = cell
-                    symbol = "A" if player == Player.A else "B"
-                    row_str += f"{symbol}{value:2d}"
+                    row_str += f"{player.name}{value:2d}"
             row_str += "|"
             result.append(row_str)
         
@@ -186,26 +256,207 @@ class GameBoard:
         return "\n".join(result)
 
 
+class NumpyGameBoard(GameBoard):
+    """
+    GameBoard stored as NumPy arrays, for deployments without the C++ engine
+    
+    The grid is an owner array (0 empty, else the player's number) and a
+    value array. A player's best move value at every cell is the maximum of
+    their values shifted into the eight neighbouring positions, plus one, so
+    move generation, mobility and max values are a few whole-array operations
+    instead of Python loops over cells. board and player_positions are built
+    on access for code that reads them directly.
+    """
+    
+    def __init__(self, size: int = 6, num_players: int = 2):
+        if not NUMPY_AVAILABLE:
+            raise ImportError("NumpyGameBoard requires numpy")
+        if not 2 <= num_players <= 4:
+            raise ValueError("num_players must be between 2 and 4")
+        
+        self.size = size
+        self.num_players = num_players
+        self.players = list(Player)[:num_players]
+        self.owner = np.zeros((size, size), dtype=np.int8)
+        self.values = np.zeros((size, size), dtype=np.int16)
+        self.history = []
+        
+        for player in self.players:
+            row, col = self.corner(player)
+            self.set_cell(row, col, player, 1)
+    
+    @property
+    def board(self):
+        """The grid as lists of (player, value) or None, like GameBoard.board"""
+        return [[None if owner == 0 else (Player(owner), value)
+                 for owner, value in zip(owners, values)]
+                for owners, values in zip(self.owner.tolist(), self.values.tolist())]
+    
+    @property
+    def player_positions(self):
+        """Cells of each player, like GameBoard.player_positions"""
+        return {player: set(zip(*(index.tolist() for index in np.nonzero(self.owner == player.value))))
+                for player in self.players}
+    
+    def get_cell(self, row: int, col: int) -> Optional[Tuple[Player, int]]:
+        """Get the value at a cell"""
+        if 0 <= row < self.size and 0 <= col < self.size and self.owner[row, col]:
+            return Player(int(self.owner[row, col])), int(self.values[row, col])
+        return None
+    
+    def set_cell(self, row: int, col: int, player: Player, value: int):
+        """Set a cell value"""
+        self.owner[row, col] = player.value
+        self.values[row, col] = value
+    
+    def move_values(self, player: Player):
+        """
+        Value a move by player would take at each cell, 0 where illegal:
+        the maximum of the player's values over the eight neighbours plus
+        one, on empty cells next to the player
+        """
+        padded = np.zeros((self.size + 2, self.size + 2), dtype=np.int16)
+        padded[1:-1, 1:-1] = np.where(self.owner == player.value, self.values, 0)
+        best = np.zeros((self.size, self.size), dtype=np.int16)
+        for dr in range(3):
+            for dc in range(3):
+                if dr != 1 or dc != 1:
+                    np.maximum(best, padded[dr:dr + self.size, dc:dc + self.size], out=best)
+        return np.where((best > 0) & (self.owner == 0), best + 1, 0)
+    
+    def get_valid_moves(self, player: Player) -> List[Tuple[int, int, int]]:
+        """
+        Get all valid moves for a player
+        
+        Returns:
+            List of tuples (row, col, value) representing valid moves
+        """
+        values = self.move_values(player)
+        rows, cols = np.nonzero(values)
+        return list(zip(rows.tolist(), cols.tolist(), values[rows, cols].tolist()))
+    
+    def make_move(self, row: int, col: int, player: Player, value: int) -> bool:
+        """
+        Make a move on the board
+        
+        Returns:
+            True if move was valid and made, False otherwise
+        """
+        if not (0 <= row < self.size and 0 <= col < self.size):
+            return False
+        if value <= 0 or self.move_values(player)[row, col] != value:
+            return False
+        
+        self.set_cell(row, col, player, value)
+        self.history.append((player, row, col, value))
+        return True
+    
+    def get_max_value(self, player: Player) -> int:
+        """Get the maximum value for a player"""
+        return int(self.values[self.owner == player.value].max(initial=0))
+    
+    def cell_count(self, player: Player) -> int:
+        """Number of cells a player owns"""
+        return int(np.count_nonzero(self.owner == player.value))
+    
+    def mobility(self, player: Player) -> int:
+        """Number of valid moves (distinct empty cells) for a player"""
+        return int(np.count_nonzero(self.move_values(player)))
+    
+    def is_game_over(self) -> bool:
+        """Check if the game is over"""
+        # Over when no empty cell touches any occupied one
+        padded = np.zeros((self.size + 2, self.size + 2), dtype=bool)
+        padded[1:-1, 1:-1] = self.owner != 0
+        near = np.zeros((self.size, self.size), dtype=bool)
+        for dr in range(3):
+            for dc in range(3):
+                near |= padded[dr:dr + self.size, dc:dc + self.size]
+        return not np.any(near & (self.owner == 0))
+    
+    def to_planes(self):
+        """Owner and value planes, as GameBoard.to_planes"""
+        return np.stack([self.owner, self.values]).astype(np.int32)
+    
+    def copy(self):
+        """Create a copy of the board"""
+        new_board = NumpyGameBoard.__new__(NumpyGameBoard)
+        new_board.size = self.size
+        new_board.num_players = self.num_players
+        new_board.players = self.players
+        new_board.owner = self.owner.copy()
+        new_board.values = self.values.copy()
+        new_board.history = list(self.history)
+        return new_board
+
+
 class SequenciumAI:
     """AI player using Minimax with Alpha-Beta pruning"""
     
-    def __init__(self, max_depth: int = 4, use_cpp: bool = True):
+    def __init__(self, max_depth: int = 4, use_cpp: bool = True, multi_mode: str = 'paranoid',
+                 tt_memory_fraction: float = 0.0, book_path: Optional[str] = None,
+                 book_min_visits: int = 16, max_nodes: int = 0, threads: int = 1,
+                 record_requests: Optional[str] = None, auto_engine: bool = False,
+                 time_ms: float = 0.0):
         """
         Initialize the AI
         
         Args:
             max_depth: Maximum search depth for minimax
             use_cpp: Use C++ backend if available (default: True)
+            multi_mode: Search used with 3-4 players, 'paranoid' or 'maxn'
+                (C++ only; the Python fallback always uses paranoid)
+            tt_memory_fraction: If > 0, size the C++ transposition table to this
+                fraction of the cgroup memory headroom instead of a fixed 1M entries
+            book_path: Memory-mapped experience book to consult and update (C++ only)
+            book_min_visits: Games a book move needs before it is played
+            max_nodes: If > 0, stop the C++ search after exactly this many nodes
+                and play the best move of the last completed iteration
+                (max_depth still caps the iterations)
+            threads: Number of C++ search threads (1 with max_nodes, whose
+                result is reproducible only on a single thread)
+            record_requests: Append every C++ search request to this binary log
+                (replay it with `benchmark.py replay`)
+            auto_engine: Let the C++ dispatcher pick an engine per position
+                (exact solver once regions separate, sparse engine on large
+                boards, alpha-beta otherwise); see `last_engine`
+            time_ms: If > 0, time budget per move for the dispatcher's search
         """
+        if max_nodes and threads > 1:
+            raise ValueError("a node-limited search runs on one thread")
         self.max_depth = max_depth
+        self.multi_mode = multi_mode
+        self.max_nodes = max_nodes
+        self.threads = threads
+        self.auto_engine = auto_engine
+        self.time_ms = time_ms
         self.nodes_evaluated = 0
+        self.last_engine = None
+        
+        # Time split of the last C++ call: board conversion vs search (seconds)
+        self.last_convert_time = 0.0
+        self.last_search_time = 0.0
         self.use_cpp = use_cpp and CPP_AVAILABLE
         
         # Initialize C++ engine if available and requested
         if self.use_cpp:
-            self.cpp_engine = cpp_engine.SearchEngine()
+            self.cpp_engine = cpp_engine.SearchEngine(tt_memory_fraction=tt_memory_fraction)
+            if book_path:
+                self.cpp_engine.open_experience_book(book_path, book_min_visits)
+            if os.path.exists(ORDERING_TABLES):
+                self.cpp_engine.load_ordering_tables(ORDERING_TABLES)
+            if os.path.exists(SEARCH_PARAMS):
+                self.cpp_engine.load_params(SEARCH_PARAMS)
+            if os.path.exists(REGION_SHAPES) and not cpp_engine.region_db_stats()['open']:
+                cpp_engine.open_region_db(REGION_SHAPES)
+            if record_requests:
+                self.cpp_engine.start_recording(record_requests)
         else:
             self.cpp_engine = None
+        # Created on first use for boards larger than the dense engine supports
+        self.sparse_engine = None
+        self.dispatcher = (cpp_engine.Dispatcher(self.cpp_engine)
+                           if self.cpp_engine and auto_engine else None)
     
     def evaluate_position(self, board: GameBoard, player: Player) -> float:
         """
@@ -216,16 +467,19 @@ class SequenciumAI:
         - Secondary: number of cells controlled
         - Tertiary: number of valid moves available
         """
-        opponent = Player.B if player == Player.A else Player.A
+        opponents = [p for p in board.players if p != player]
+        n = len(opponents)
         
-        # Max value difference (most important)
-        max_diff = board.get_max_value(player) - board.get_max_value(opponent)
+        # Max value difference (most important), against the strongest opponent
+        max_diff = board.get_max_value(player) - max(board.get_max_value(p) for p in opponents)
         
-        # Number of cells controlled
-        cell_diff = len(board.player_positions[player]) - len(board.player_positions[opponent])
+        # Number of cells controlled (against the opponents' average)
+        opponent_cells = sum(board.cell_count(p) for p in opponents)
+        cell_diff = board.cell_count(player) - opponent_cells // n
         
         # Number of valid moves (mobility)
-        mobility_diff = len(board.get_valid_moves(player)) - len(board.get_valid_moves(opponent))
+        opponent_mobility = sum(board.mobility(p) for p in opponents)
+        mobility_diff = board.mobility(player) - opponent_mobility // n
         
         # Combined score
         score = max_diff * 100 + cell_diff * 10 + mobility_diff
@@ -294,6 +548,62 @@ class SequenciumAI:
             
             return min_eval, best_move
     
+    def paranoid(self, board: GameBoard, depth: int, alpha: float, beta: float,
+                 to_move: Player, player: Player) -> Tuple[float, Optional[Tuple[int, int, int]]]:
+        """
+        Paranoid alpha-beta for 3-4 players: all opponents minimize the
+        evaluation of the searching player
+        
+        Returns:
+            Tuple of (score, best_move)
+        """
+        self.nodes_evaluated += 1
+        
+        if depth == 0 or board.is_game_over():
+            return self.evaluate_position(board, player), None
+        
+        next_player = board.next_player(to_move)
+        valid_moves = board.get_valid_moves(to_move)
+        
+        if not valid_moves:
+            return self.paranoid(board, depth - 1, alpha, beta, next_player, player)
+        
+        maximizing = to_move == player
+        best_eval = float('-inf') if maximizing else float('inf')
+        best_move = None
+        
+        for move in valid_moves:
+            row, col, value = move
+            new_board = board.copy()
+            new_board.make_move(row, col, to_move, value)
+            
+            eval_score, _ = self.paranoid(new_board, depth - 1, alpha, beta, next_player, player)
+            
+            if (eval_score > best_eval) if maximizing else (eval_score < best_eval):
+                best_eval = eval_score
+                best_move = move
+            
+            if maximizing:
+                alpha = max(alpha, eval_score)
+            else:
+                beta = min(beta, eval_score)
+            if beta <= alpha:
+                break
+        
+        return best_eval, best_move
+    
+    def record_game(self, board: GameBoard):
+        """
+        Add a finished two-player game to the experience book, if one is open
+        """
+        if self.cpp_engine is None or board.num_players != 2:
+            return
+        if self.cpp_engine.get_book_stats()[1] == 0:
+            return
+        
+        moves = [(player.value, row, col, value) for player, row, col, value in board.history]
+        self.cpp_engine.record_game(board.size, moves)
+    
     def get_best_move(self, board: GameBoard, player: Player) -> Optional[Tuple[int, int, int]]:
         """
         Get the best move for the current player
@@ -312,25 +622,50 @@ class SequenciumAI:
             try:
                 # Convert player enum to int (A=1, B=2)
                 player_id = player.value
+                start = time.perf_counter()
                 
-                # Convert board to format C++ expects: list of lists with (player_id, value) tuples
-                converted_board = []
-                for row in board.board:
-                    converted_row = []
-                    for cell in row:
-                        if cell is None:
-                            converted_row.append(None)
-                        else:
-                            player_obj, value = cell
-                            # Convert Player enum to int
-                            converted_row.append((player_obj.value, value))
-                    converted_board.append(converted_row)
+                # Boards beyond the dense engine's limit go to the sparse
+                # frontier engine, which only needs the occupied cells
+                if (not self.auto_engine and board.size > cpp_engine.MAX_BOARD_SIZE
+                        and board.num_players == 2):
+                    if self.sparse_engine is None:
+                        self.sparse_engine = cpp_engine.SparseEngine()
+                        self.sparse_engine.set_params(self.cpp_engine.get_params())
+                    cells = [(row, col, owner.value, board.board[row][col][1])
+                             for owner, positions in board.player_positions.items()
+                             for row, col in positions]
+                    converted = time.perf_counter()
+                    self.last_convert_time = converted - start
+                    row, col, value, nodes = self.sparse_engine.find_best_move(
+                        cells, board.size, player_id, self.max_depth, self.max_nodes
+                    )
+                    self.last_search_time = time.perf_counter() - converted
+                    self.nodes_evaluated = nodes
+                    return (row, col, value)
+                
+                converted_board = board.to_engine_board()
+                
+                converted = time.perf_counter()
+                self.last_convert_time = converted - start
                 
                 # Call C++ search
-                row, col, value, nodes = self.cpp_engine.find_best_move(
-                    converted_board, board.size, player_id, self.max_depth
-                )
+                if self.auto_engine:
+                    row, col, value, nodes, self.last_engine = self.dispatcher.find_best_move(
+                        converted_board, board.size, player_id, self.max_depth, self.time_ms,
+                        board.num_players, self.max_nodes, self.threads
+                    )
+                elif board.num_players > 2:
+                    row, col, value, nodes = self.cpp_engine.find_best_move_multi(
+                        converted_board, board.size, player_id, self.max_depth,
+                        board.num_players, self.multi_mode
+                    )
+                else:
+                    row, col, value, nodes = self.cpp_engine.find_best_move(
+                        converted_board, board.size, player_id, self.max_depth,
+                        self.max_nodes, self.threads
+                    )
                 
+                self.last_search_time = time.perf_counter() - converted
                 self.nodes_evaluated = nodes
                 return (row, col, value)
             except Exception as e:
@@ -339,12 +674,17 @@ class SequenciumAI:
                 self.use_cpp = False
         
         # Fall back to Python implementation
-        _, best_move = self.minimax(board, self.max_depth, float('-inf'), float('inf'), True, player)
+        if board.num_players > 2:
+            _, best_move = self.paranoid(board, self.max_depth, float('-inf'), float('inf'),
+                                         player, player)
+        else:
+            _, best_move = self.minimax(board, self.max_depth, float('-inf'), float('inf'), True, player)
         
         return best_move
 
 
-def play_game(board_size: int = 6, ai_depth: int = 4, interactive: bool = False):
+def play_game(board_size: int = 6, ai_depth: int = 4, interactive: bool = False,
+              num_players: int = 2):
     """
     Play a complete game of Sequencium
     
@@ -352,8 +692,12 @@ def play_game(board_size: int = 6, ai_depth: int = 4, interactive: bool = False)
         board_size: Size of the game board
         ai_depth: Search depth for AI
         interactive: If True, pause between moves
+        num_players: Number of players (2-4)
     """
-    board = GameBoard(board_size)
+    # Without the C++ engine the Python search does all the work, on the
+    # array-backed board when NumPy is there
+    board_class = NumpyGameBoard if NUMPY_AVAILABLE and not CPP_AVAILABLE else GameBoard
+    board = board_class(board_size, num_players)
     ai = SequenciumAI(max_depth=ai_depth)
     
     current_player = Player.A
@@ -375,7 +719,7 @@ def play_game(board_size: int = 6, ai_depth: int = 4, interactive: bool = False)
         
         if not valid_moves:
             print(f"Player {current_player.name} has no valid moves. Switching to opponent.")
-            current_player = Player.B if current_player == Player.A else Player.A
+            current_player = board.next_player(current_player)
             continue
         
         move_count += 1
@@ -395,11 +739,13 @@ def play_game(board_size: int = 6, ai_depth: int = 4, interactive: bool = False)
             print(board)
         
         # Switch player
-        current_player = Player.B if current_player == Player.A else Player.A
+        current_player = board.next_player(current_player)
         
         if interactive:
             input("\nPress Enter to continue...")
     
+    ai.record_game(board)
+    
     print("\n" + "="*50)
     print("GAME OVER!")
     print("="*50)
@@ -408,11 +754,8 @@ def play_game(board_size: int = 6, ai_depth: int = 4, interactive: bool = False)
     print(board)
     print()
     
-    max_a = board.get_max_value(Player.A)
-    max_b = board.get_max_value(Player.B)
-    
-    print(f"Player A maximum value: {max_a}")
-    print(f"Player B maximum value: {max_b}")
+    for player in board.players:
+        print(f"Player {player.name} maximum value: {board.get_max_value(player)}")
     print(f"Total moves played: {move_count}")
     print()
     
@@ -447,6 +790,7 @@ def main():
     board_size = 6
     ai_depth = 4
     interactive = False
+    num_players = 2
     
     if len(sys.argv) > 1:
         try:
@@ -463,13 +807,23 @@ def main():
     if len(sys.argv) > 3 and sys.argv[3].lower() in ['true', 'yes', '1', 'interactive']:
         interactive = True
     
+    if len(sys.argv) > 4:
+        try:
+            num_players = int(sys.argv[4])
+            if not 2 <= num_players <= 4:
+                raise ValueError
+        except ValueError:
+            print("Invalid number of players. Using default 2.")
+            num_players = 2
+    
     print(f"Configuration:")
     print(f"  Board Size: {board_size}x{board_size}")
     print(f"  AI Search Depth: {ai_depth}")
     print(f"  Interactive Mode: {interactive}")
+    print(f"  Players: {num_players}")
     print()
     
-    play_game(board_size, ai_depth, interactive)
+    play_game(board_size, ai_depth, interactive, num_players)
 
 
 if __name__ == "__main__":
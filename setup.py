@@ -14,7 +14,8 @@ ext_modules = [
         sources=['search_engine.cpp'],
         include_dirs=[pybind11.get_include()],
         language='c++',
-        extra_compile_args=['-std=c++17', '-O3', '-march=native', '-ffast-math'],
+        extra_compile_args=['-std=c++17', '-O3', '-march=native', '-ffast-math', '-pthread'],
+        extra_link_args=['-pthread'],
     ),
 ]
 
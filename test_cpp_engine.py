@@ -165,6 +165,877 @@ def test_cpp_transposition_table():
     else:
         assert cpp_nodes < py_nodes, "C++ should evaluate fewer nodes due to transposition table"
 
+def test_cpp_multiplayer():
+    """Test paranoid and max^n search with 3 and 4 players"""
+    if not CPP_AVAILABLE:
+        return
+    
+    for num_players in (3, 4):
+        board = GameBoard(6, num_players=num_players)
+        board.make_move(1, 1, Player.A, 2)
+        board.make_move(4, 4, Player.B, 2)
+        
+        for mode in ('paranoid', 'maxn'):
+            ai = SequenciumAI(max_depth=3, use_cpp=True, multi_mode=mode)
+            move = ai.get_best_move(board, Player.C)
+            assert move in board.get_valid_moves(Player.C)
+            print(f"  {num_players} players, {mode}: {move}, nodes: {ai.nodes_evaluated}")
+    
+    # One empty cell with three players: passes allow up to 3 plies per
+    # empty cell, so iterative deepening goes to depth 4
+    board = GameBoard(4, num_players=3)
+    players = [Player.A, Player.B, Player.C]
+    for i in range(2, 16):
+        board.set_cell(i // 4, i % 4, players[i % 3], 2)
+    ai = SequenciumAI(max_depth=20, use_cpp=True, multi_mode='paranoid')
+    assert ai.get_best_move(board, Player.B) == (0, 1, 3)
+    assert ai.cpp_engine.get_search_stats()["completed_depth"] == 4
+    
+    print("✓ C++ multi-player test passed")
+
+def test_cpp_tt_auto_size():
+    """Test transposition table sizing options"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import search_engine
+    
+    engine = search_engine.SearchEngine(tt_size=4096)
+    assert engine.get_tt_size() == 4096
+    
+    # Without a cgroup memory limit the auto mode keeps the default size
+    auto_engine = search_engine.SearchEngine(tt_memory_fraction=0.05)
+    assert auto_engine.get_tt_size() >= 1024
+    auto_engine.check_memory_pressure(force=True)
+    
+    # Shrinking in place keeps the entries: the same search is answered
+    # from the table
+    board = GameBoard(6)
+    first = auto_engine.find_best_move(board.to_engine_board(), 6, Player.A.value, 5)
+    half = max(auto_engine.get_tt_size() // 2, 1024)
+    auto_engine.rehash_tt(half)
+    assert auto_engine.get_tt_size() == half
+    again = auto_engine.find_best_move(board.to_engine_board(), 6, Player.A.value, 5)
+    assert again[:3] == first[:3]
+    assert auto_engine.get_search_stats()["tt_hits"] > 0 and again[3] < first[3]
+    
+    ai = SequenciumAI(max_depth=3, use_cpp=True, tt_memory_fraction=0.05)
+    board = GameBoard(6)
+    assert ai.get_best_move(board, Player.A) in board.get_valid_moves(Player.A)
+    
+    print(f"✓ TT auto-size test passed ({auto_engine.get_tt_size()} entries)")
+
+def test_cpp_experience_book():
+    """Test that recorded games are replayed from the experience book"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import os
+    import tempfile
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "experience.book")
+        ai = SequenciumAI(max_depth=2, use_cpp=True, book_path=path, book_min_visits=2)
+        
+        board = GameBoard(5)
+        player = Player.A
+        while not board.is_game_over():
+            move = ai.get_best_move(board, player)
+            if move:
+                board.make_move(move[0], move[1], player, move[2])
+            player = board.next_player(player)
+        
+        ai.record_game(board)
+        ai.record_game(board)
+        entries, capacity, _ = ai.cpp_engine.get_book_stats()
+        assert 0 < entries <= capacity
+        
+        # The first move now comes straight from the book
+        move = ai.get_best_move(GameBoard(5), Player.A)
+        assert ai.nodes_evaluated == 0
+        assert move == board.history[0][1:]
+        
+        # A best move whose results drop gives way to a better sibling
+        import search_engine
+        engine = search_engine.SearchEngine(4096)
+        engine.open_experience_book(os.path.join(tmp, "siblings.book"), 1)
+        win_x = [(1, 0, 1, 2), (2, 2, 1, 2), (1, 1, 1, 3)]
+        win_y = [(1, 1, 0, 2), (2, 2, 1, 2), (1, 1, 1, 3)]
+        tie_x = [(1, 0, 1, 2), (2, 1, 1, 2), (1, 0, 2, 3), (2, 1, 0, 3)]
+        for game in (win_x, win_y, tie_x):
+            engine.record_game(3, game)
+        assert (engine.find_best_move(GameBoard(3).to_engine_board(), 3, Player.A.value, 4) ==
+                (1, 0, 2, 0))
+        
+        try:
+            engine.record_game(3, [(1, 0, 1, 100)])
+            assert False, "move value 100 accepted"
+        except ValueError:
+            pass
+        
+        # A truncated book is refused rather than mapped past its end
+        truncated = os.path.join(tmp, "truncated.book")
+        with open(path, "rb") as source, open(truncated, "wb") as target:
+            target.write(source.read(os.path.getsize(path) // 2))
+        try:
+            search_engine.SearchEngine(4096).open_experience_book(truncated)
+            assert False, "truncated book accepted"
+        except RuntimeError:
+            pass
+    
+    print(f"✓ Experience book test passed ({entries} entries)")
+
+def test_cpp_node_limit():
+    """Test that node-limited search is exact and reproducible"""
+    if not CPP_AVAILABLE:
+        return
+    
+    board = GameBoard(8)
+    board.make_move(1, 1, Player.A, 2)
+    board.make_move(6, 6, Player.B, 2)
+    
+    # Fresh AIs and repeated searches on one AI (whose engine keeps its
+    # table between moves) all find the same move at the same depth
+    moves, depths = set(), set()
+    reused = SequenciumAI(max_depth=64, use_cpp=True, max_nodes=3000)
+    for ai in [SequenciumAI(max_depth=64, use_cpp=True, max_nodes=3000) for _ in range(3)] + [reused] * 3:
+        move = ai.get_best_move(board, Player.A)
+        assert ai.nodes_evaluated == 3000
+        assert move in board.get_valid_moves(Player.A)
+        moves.add(move)
+        depths.add(ai.cpp_engine.get_search_stats()["completed_depth"])
+    assert len(moves) == 1 and len(depths) == 1
+    
+    # Helper threads would make the result depend on scheduling
+    import search_engine
+    engine = search_engine.SearchEngine()
+    for threads, nodes in ((4, 3000), (0, 0), (257, 0)):
+        try:
+            engine.find_best_move(board.to_engine_board(), 8, Player.A.value, 64, nodes, threads)
+            assert False, f"threads={threads} with nodes={nodes} accepted"
+        except ValueError:
+            pass
+    try:
+        SequenciumAI(max_nodes=3000, threads=4)
+        assert False, "threads with max_nodes accepted"
+    except ValueError:
+        pass
+    
+    print(f"✓ Node-limited search test passed (move {moves.pop()})")
+
+def test_cpp_search_stats():
+    """Test per-search thread and transposition table counters"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import search_engine
+    
+    board = GameBoard(6)
+    engine = search_engine.SearchEngine()
+    for threads in (1, 2):
+        engine.clear_tt()
+        nodes = engine.find_best_move(board.to_engine_board(), 6, Player.A.value, 4, 0, threads)[3]
+        stats = engine.get_search_stats()
+        assert stats["threads"] == threads and stats["completed_depth"] == 4
+        assert stats["nodes"] == nodes and stats["main_nodes"] <= nodes
+        assert stats["tt_probes"] == nodes
+        assert stats["tt_hits"] <= stats["tt_probes"]
+        assert stats["tt_overwrites"] <= stats["tt_stores"] <= stats["tt_probes"]
+    
+    print("✓ Search stats test passed")
+
+def test_cpp_evaluate_batch():
+    """Test static evaluation terms of stacked positions"""
+    if not CPP_AVAILABLE:
+        return
+    try:
+        import numpy as np
+    except ImportError:
+        print("Skipping batch evaluation test - numpy not installed")
+        return
+    
+    import random
+    import search_engine
+    
+    rng = random.Random(0)
+    boards, players = [], []
+    for _ in range(64):
+        board = GameBoard(6)
+        player = Player.A
+        for _ in range(rng.randrange(20)):
+            moves = board.get_valid_moves(player)
+            if moves:
+                row, col, value = rng.choice(moves)
+                board.make_move(row, col, player, value)
+            player = board.next_player(player)
+        boards.append(board)
+        players.append(rng.choice([Player.A, Player.B]))
+    
+    engine = search_engine.SearchEngine(1024)
+    planes = np.stack([board.to_planes() for board in boards])
+    sides = np.array([player.value for player in players], dtype=np.int32)
+    terms = engine.evaluate_batch(planes, sides, threads=1)
+    assert terms.shape == (64, 5)
+    assert (engine.evaluate_batch(planes, sides, threads=4) == terms).all()
+    
+    # 4096 positions fill four workers, reused by the second call
+    many_planes, many_sides = np.tile(planes, (64, 1, 1, 1)), np.tile(sides, 64)
+    for _ in range(2):
+        many = engine.evaluate_batch(many_planes, many_sides, threads=4)
+        assert (many == np.tile(terms, (64, 1))).all()
+    
+    weights = engine.get_params()
+    for board, player, row in zip(boards, players, terms):
+        other = Player.B if player == Player.A else Player.A
+        assert row[0] == board.get_max_value(player) - board.get_max_value(other)
+        assert row[1] == len(board.player_positions[player]) - len(board.player_positions[other])
+        assert row[2] == len(board.get_valid_moves(player)) - len(board.get_valid_moves(other))
+        assert row[4] == (row[0] * weights["max_value_weight"] + row[1] * weights["cell_weight"] +
+                          row[2] * weights["mobility_weight"])
+    
+    # A's wall in column 2 keeps B (column 3) out of the 7 empty cells
+    board = GameBoard(4)
+    for r in range(4):
+        board.set_cell(r, 2, Player.A, 2)
+        board.set_cell(r, 3, Player.B, 2)
+    territory = engine.evaluate_batch(board.to_planes()[None], np.array([1], dtype=np.int32))[0, 3]
+    assert territory == 7
+    
+    try:
+        engine.evaluate_batch(planes[:, :1], sides)
+        assert False, "a missing value plane should be rejected"
+    except ValueError:
+        pass
+    
+    for bad in (0, 100):
+        corrupt = planes.copy()
+        owned = np.argwhere(corrupt[:, 0] != 0)[0]
+        corrupt[owned[0], 1, owned[1], owned[2]] = bad
+        try:
+            engine.evaluate_batch(corrupt, sides)
+            assert False, f"an owned cell with value {bad} should be rejected"
+        except ValueError:
+            pass
+    
+    print("✓ Batch evaluation test passed")
+
+def test_cpp_lazy_eval():
+    """Test that lazy leaf evaluation does not change search results"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import random
+    import search_engine
+    
+    lazy = search_engine.SearchEngine(1 << 16)
+    full = search_engine.SearchEngine(1 << 16)
+    assert lazy.is_lazy_eval()
+    full.set_lazy_eval(False)
+    assert not full.is_lazy_eval()
+    
+    rng = random.Random(3)
+    for _ in range(8):
+        board = GameBoard(6)
+        player = Player.A
+        for _ in range(rng.randrange(4, 16)):
+            moves = board.get_valid_moves(player)
+            if moves:
+                row, col, value = rng.choice(moves)
+                board.make_move(row, col, player, value)
+            player = board.next_player(player)
+        if not board.get_valid_moves(player):
+            continue
+        # Leaves outside the window return bounds, so the root is unchanged
+        lazy.clear_tt()
+        full.clear_tt()
+        assert (lazy.find_best_move(board.to_engine_board(), 6, player.value, 5)[:3] ==
+                full.find_best_move(board.to_engine_board(), 6, player.value, 5)[:3])
+    
+    print("✓ Lazy evaluation test passed")
+
+def test_cpp_mtdf():
+    """Test the MTD(f) root driver against full-window alpha-beta"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import random
+    import search_engine
+    
+    engine = search_engine.SearchEngine(1 << 16)
+    assert engine.get_root_driver() == "alphabeta"
+    
+    rng = random.Random(5)
+    agree = searched = 0
+    for _ in range(6):
+        board = GameBoard(6)
+        player = Player.A
+        for _ in range(rng.randrange(2, 12)):
+            moves = board.get_valid_moves(player)
+            if moves:
+                row, col, value = rng.choice(moves)
+                board.make_move(row, col, player, value)
+            player = board.next_player(player)
+        if not board.get_valid_moves(player):
+            continue
+        
+        engine.set_root_driver("alphabeta")
+        engine.clear_tt()
+        expected = engine.find_best_move(board.to_engine_board(), 6, player.value, 5)
+        assert engine.get_search_stats()["passes"] == 0
+        engine.set_root_driver("mtdf")
+        engine.clear_tt()
+        move = engine.find_best_move(board.to_engine_board(), 6, player.value, 5)
+        # Zero-window searches converge on the same value; ties may pick
+        # another move of that value
+        assert move[:3] in board.get_valid_moves(player)
+        assert engine.get_search_stats()["passes"] >= 5
+        agree += move[:3] == expected[:3]
+        searched += 1
+    assert agree >= searched - 1
+    
+    engine.set_root_driver("mtdf")
+    engine.find_best_move(GameBoard(6).to_engine_board(), 6, Player.A.value, 6, 0, 2)
+    try:
+        engine.set_root_driver("pvs")
+        assert False, "unknown driver should be rejected"
+    except ValueError:
+        pass
+    
+    print("✓ MTD(f) driver test passed")
+
+def test_cpp_numa_policy():
+    """Test NUMA placement of the transposition table and thread pinning"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import search_engine
+    
+    nodes = search_engine.numa_nodes()
+    assert len(nodes) >= 1
+    
+    board = GameBoard(6)
+    local = search_engine.SearchEngine(1 << 16)
+    expected = local.find_best_move(board.to_engine_board(), 6, Player.A.value, 4)
+    
+    # Placement changes where the table lives, not what the search finds
+    engine = search_engine.SearchEngine(1 << 16)
+    engine.set_numa_policy("interleave", pin_threads=True)
+    policy = engine.get_numa_policy()
+    assert policy["nodes"] == len(nodes) and policy["pin_threads"]
+    if len(nodes) == 1:
+        assert not policy["interleaved"]
+    assert engine.find_best_move(board.to_engine_board(), 6, Player.A.value, 4) == expected
+    engine.find_best_move(board.to_engine_board(), 6, Player.A.value, 4, 0, 2)
+    
+    try:
+        engine.set_numa_policy("remote")
+        assert False, "unknown placement should be rejected"
+    except ValueError:
+        pass
+    
+    print("✓ NUMA policy test passed")
+
+def test_cpp_region_db():
+    """Test endgame regions valued from the region shape database"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import os
+    import tempfile
+    import search_engine
+    
+    # A's wall in column 2 closes off the 8 cells of columns 0-1
+    board = GameBoard(4)
+    for r in range(4):
+        board.set_cell(r, 2, Player.A, r + 2)
+        board.set_cell(r, 3, Player.B, 2)
+    dispatcher = search_engine.Dispatcher(search_engine.SearchEngine())
+    row, col, value, searched, name = dispatcher.find_best_move(
+        board.to_engine_board(), 4, Player.A.value, 4)
+    assert name == "solver"
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "shapes.db")
+        stats = search_engine.build_region_db(path, 8)
+        # Shapes of up to 8 cells connected by the eight neighbours
+        assert stats["shapes"] == 22449
+        search_engine.open_region_db(path)
+        try:
+            assert search_engine.region_db_stats() == {"open": True, "max_cells": 8, "shapes": 22449}
+            result = dispatcher.find_best_move(board.to_engine_board(), 4, Player.A.value, 4)
+            # Same chain, one lookup per candidate move instead of a path search
+            assert result[:3] == (row, col, value) and result[4] == "solver"
+            assert result[3] < searched
+        finally:
+            search_engine.close_region_db()
+    assert not search_engine.region_db_stats()["open"]
+    
+    try:
+        search_engine.build_region_db(os.path.join(tempfile.gettempdir(), "unused.db"), 17)
+        assert False, "oversized shapes should be rejected"
+    except ValueError:
+        pass
+    
+    print("✓ Region shape database test passed")
+
+def test_cpp_scheduler():
+    """Test many concurrent searches on the cooperative scheduler"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import search_engine
+    
+    board = GameBoard(6)
+    board.make_move(1, 1, Player.A, 2)
+    converted = board.to_engine_board()
+    
+    scheduler = search_engine.SearchScheduler(workers=2, slice_nodes=64)
+    ids = [scheduler.submit(converted, 6, 2, 4, time_ms=(50 if i % 2 else 0))
+           for i in range(500)]
+    
+    valid_moves = board.get_valid_moves(Player.B)
+    for search_id in ids:
+        row, col, value, nodes, depth = scheduler.wait(search_id)
+        assert (row, col, value) in valid_moves
+        assert depth >= 1
+    assert scheduler.pending() == 0
+    
+    print("✓ Cooperative scheduler test passed (500 searches)")
+
+def test_cpp_ordering_tables():
+    """Test collecting cutoff statistics and loading learned ordering tables"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import os
+    import tempfile
+    import search_engine
+    
+    board = GameBoard(6)
+    board.make_move(1, 1, Player.A, 2)
+    board.make_move(4, 4, Player.B, 2)
+    
+    trainer = search_engine.SearchEngine()
+    trainer.collect_cutoff_stats(True)
+    trainer.find_best_move(board.to_engine_board(), 6, Player.A.value, 5)
+    cutoff_nodes, first_move = trainer.get_cutoff_stats()
+    assert 0 < first_move <= cutoff_nodes
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "ordering.txt")
+        trainer.save_ordering_tables(path)
+        engine = search_engine.SearchEngine()
+        engine.load_ordering_tables(path)
+        row, col, value, _ = engine.find_best_move(board.to_engine_board(), 6, Player.A.value, 5)
+        assert (row, col, value) in board.get_valid_moves(Player.A)
+    
+    print(f"✓ Ordering tables test passed (first-move cutoffs {first_move}/{cutoff_nodes})")
+
+def test_cpp_vector_env():
+    """Test the batched reinforcement-learning environment"""
+    if not CPP_AVAILABLE:
+        return
+    try:
+        import numpy as np
+    except ImportError:
+        print("Skipping vector env test - numpy not installed")
+        return
+    
+    import search_engine
+    
+    env = search_engine.VectorEnv(32, board_size=5, opponent_depth=1, threads=2)
+    obs, legal = env.reset()
+    assert obs.shape == (32, search_engine.VectorEnv.num_planes, 5, 5)
+    assert legal.shape == (32, 25)
+    
+    rng = np.random.default_rng(0)
+    finished = 0
+    for _ in range(60):
+        actions = np.array([rng.choice(np.flatnonzero(mask)) for mask in legal], dtype=np.int32)
+        obs, rewards, dones, legal = env.step(actions)
+        assert legal.any(axis=1).all()
+        assert set(np.unique(rewards[dones == 0])) <= {0.0}
+        finished += int(dones.sum())
+    assert finished > 0
+    
+    # An illegal action ends that game with a loss
+    actions = np.array([rng.choice(np.flatnonzero(mask)) for mask in legal], dtype=np.int32)
+    actions[0] = np.flatnonzero(legal[0] == 0)[0]
+    _, rewards, dones, _ = env.step(actions)
+    assert dones[0] == 1 and rewards[0] == -1.0
+    
+    print(f"✓ Vector env test passed ({finished} games finished)")
+
+def test_cpp_request_replay():
+    """Test recording search requests and replaying the log"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import os
+    import tempfile
+    import search_engine
+    
+    board = GameBoard(6)
+    board.make_move(1, 1, Player.A, 2)
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "requests.log")
+        engine = search_engine.SearchEngine()
+        engine.start_recording(path)
+        for depth in range(1, 6):
+            engine.find_best_move(board.to_engine_board(), 6, Player.B.value, depth)
+        engine.stop_recording()
+        engine.find_best_move(board.to_engine_board(), 6, Player.B.value, 2)
+        
+        report = search_engine.replay_requests(path)
+        assert report["requests"] == 5
+        assert report["latency_ms"]["count"] == 5
+        assert report["nodes"] > 0
+        
+        paced = search_engine.replay_requests(path, speed=1.0, workers=2)
+        assert paced["requests"] == 5
+        
+        # Replayed max^n requests count their nodes too
+        maxn_path = os.path.join(tmp, "maxn.log")
+        three = GameBoard(6, num_players=3)
+        engine.start_recording(maxn_path)
+        nodes = engine.find_best_move_multi(
+            three.to_engine_board(), 6, Player.A.value, 2, 3, "maxn")[3]
+        engine.stop_recording()
+        assert search_engine.replay_requests(maxn_path)["nodes"] == nodes > 0
+    
+    print(f"✓ Request replay test passed ({report['requests_per_second']:.0f} requests/s)")
+
+def test_cpp_sparse_engine():
+    """Test the sparse frontier engine on a large board"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import search_engine
+    
+    # Agrees with the dense engine where both apply
+    board = GameBoard(6)
+    board.make_move(1, 1, Player.A, 2)
+    board.make_move(4, 4, Player.B, 2)
+    cells = [(row, col, owner.value, board.board[row][col][1])
+             for owner, positions in board.player_positions.items()
+             for row, col in positions]
+    sparse = search_engine.SparseEngine()
+    row, col, value, _ = sparse.find_best_move(cells, 6, Player.A.value, 4)
+    assert (row, col, value) in board.get_valid_moves(Player.A)
+    assert sparse.frontier_size(Player.A.value) == len(board.get_valid_moves(Player.A))
+    
+    # Values beyond the table's 10 bits survive a hit on the stored root
+    long_chain = [(0, 0, Player.A.value, 2000), (19, 19, Player.B.value, 1)]
+    for _ in range(2):
+        assert sparse.find_best_move(long_chain, 20, Player.A.value, 3)[2] == 2001
+    
+    # Evaluation weights are the tunable search parameters
+    defaults = {name: default for name, default, _, _, _ in search_engine.tunable_params()}
+    assert sparse.get_params() == defaults
+    sparse.set_params({"cell_weight": 25})
+    assert sparse.get_params()["cell_weight"] == 25
+    
+    # A 40x40 game through SequenciumAI
+    board = GameBoard(40)
+    ai = SequenciumAI(max_depth=2, use_cpp=True)
+    for _ in range(30):
+        move = ai.get_best_move(board, Player.A)
+        assert move in board.get_valid_moves(Player.A)
+        board.make_move(*move[:2], Player.A, move[2])
+        reply = ai.get_best_move(board, Player.B)
+        board.make_move(*reply[:2], Player.B, reply[2])
+    assert ai.sparse_engine is not None
+    
+    print("✓ Sparse engine test passed (40x40, 60 moves)")
+
+def test_cpp_search_params():
+    """Test tunable search parameters and the native match runner"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import os
+    import tempfile
+    import search_engine
+    
+    specs = search_engine.tunable_params()
+    defaults = {name: default for name, default, _, _, _ in specs}
+    engine = search_engine.SearchEngine()
+    assert engine.get_params() == defaults
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "params.txt")
+        engine.set_params({"cell_weight": 25})
+        engine.save_params(path)
+        fresh = search_engine.SearchEngine()
+        fresh.load_params(path)
+        assert fresh.get_params()["cell_weight"] == 25
+    
+    # Ignoring the max value should lose to the defaults
+    weak = dict(defaults, max_value_weight=1, cell_weight=0, mobility_weight=100)
+    wins, losses, draws = search_engine.play_match(defaults, weak, games=32, depth=2, threads=2)
+    assert wins + losses + draws == 32
+    assert wins > losses
+    
+    print(f"✓ Search params test passed (defaults vs weak: +{wins} -{losses} ={draws})")
+
+def test_cpp_analysis_pipeline():
+    """Test the streaming archive analysis pipeline"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import json
+    import os
+    import random
+    import tempfile
+    import search_engine
+    
+    rng = random.Random(1)
+    records = []
+    for _ in range(20):
+        board = GameBoard(5)
+        player = Player.A
+        while not board.is_game_over():
+            moves = board.get_valid_moves(player)
+            if moves:
+                row, col, value = rng.choice(moves)
+                board.make_move(row, col, player, value)
+            player = board.next_player(player)
+        records.append(board)
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        archive = os.path.join(tmp, "games.txt")
+        output = os.path.join(tmp, "analysis.jsonl")
+        with open(archive, "w") as f:
+            f.write("# random games\n")
+            for board in records:
+                f.write(board.to_record() + "\n")
+        
+        report = search_engine.analyse_archive(archive, output, depth=2, workers=3, queue_size=4)
+        assert report["games"] == 20
+        assert report["positions"] == sum(len(board.history) for board in records)
+        
+        with open(output) as f:
+            games = [json.loads(line) for line in f]
+        assert [game["game"] for game in games] == list(range(20))
+        for game, board in zip(games, records):
+            assert len(game["moves"]) == len(board.history)
+            assert "error" not in game
+    
+    print(f"✓ Analysis pipeline test passed ({report['positions']} positions)")
+
+def test_cpp_region_tracker():
+    """Test incremental empty-region tracking with rollback"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import search_engine
+    
+    board = GameBoard(5)
+    regions = search_engine.RegionTracker(board.to_engine_board(), 5)
+    assert regions.region_count() == 1 and not regions.separated()
+    
+    # A wall of A cells down column 2 splits the empty cells in two,
+    # but B can still reach A's side of it
+    for row in range(5):
+        regions.make_move(row, 2, Player.A.value, row + 2)
+    assert regions.region_count() == 2
+    assert regions.region_of(1, 0) != regions.region_of(1, 4)
+    assert regions.region_of(0, 2) == -1
+    assert not regions.separated()
+    
+    # A second wall of B cells in column 3 separates the players
+    for row in range(5):
+        regions.make_move(row, 3, Player.B.value, 2)
+    assert regions.separated()
+    assert (1, 0) in regions.region_cells(4, 1)
+    
+    for _ in range(10):
+        regions.unmake_move()
+    assert regions.region_count() == 1 and not regions.separated()
+    
+    print("✓ Region tracker test passed")
+
+def test_cpp_dispatcher():
+    """Test per-position engine selection"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import search_engine
+    
+    engine = search_engine.SearchEngine()
+    dispatcher = search_engine.Dispatcher(engine)
+    assert dispatcher.engines()[-1] == "alphabeta"
+    
+    # Open position: alpha-beta
+    board = GameBoard(6)
+    row, col, value, _, name = dispatcher.find_best_move(
+        board.to_engine_board(), 6, Player.A.value, 4)
+    assert name == "alphabeta"
+    assert (row, col, value) in board.get_valid_moves(Player.A)
+    
+    # Walls in columns 2 (A) and 3 (B) separate the players: exact solver
+    board = GameBoard(5)
+    for r in range(5):
+        board.set_cell(r, 2, Player.A, r + 2)
+        board.set_cell(r, 3, Player.B, 2)
+    row, col, value, _, name = dispatcher.find_best_move(
+        board.to_engine_board(), 5, Player.A.value, 4)
+    assert name == "solver"
+    assert (row, col, value) in board.get_valid_moves(Player.A)
+    assert dispatcher.get_last_decision()["separated"]
+    
+    # Open 10x10 position with 25 legal moves: MCTS, nodes counting playouts
+    board = GameBoard(10)
+    for c in range(1, 9):
+        board.set_cell(4, c, Player.A, c)
+        board.set_cell(6, c, Player.B, c)
+    row, col, value, playouts, name = dispatcher.find_best_move(
+        board.to_engine_board(), 10, Player.A.value, 4, nodes=500)
+    assert name == "mcts" and playouts == 500
+    assert (row, col, value) in board.get_valid_moves(Player.A)
+    assert dispatcher.get_last_decision()["branching"] == 25
+    
+    # Time-limited search through SequenciumAI
+    ai = SequenciumAI(max_depth=20, auto_engine=True, time_ms=50)
+    move = ai.get_best_move(GameBoard(8), Player.A)
+    assert move is not None and ai.last_engine == "alphabeta"
+    
+    stats = dispatcher.get_stats()
+    assert stats["alphabeta"]["calls"] == 1 and stats["solver"]["calls"] == 1
+    assert stats["mcts"]["calls"] == 1 and stats["mcts"]["nodes"] == 500
+    
+    print("✓ Dispatcher test passed")
+
+def test_cpp_verified_keys():
+    """Test exact position keys on positions whose hashes collide"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import search_engine
+    
+    # Both boards have the same 64-bit search hash
+    x = [[None] * 4 for _ in range(4)]
+    y = [[None] * 4 for _ in range(4)]
+    x[0][0], x[0][1], x[3][3] = (1, 2), (1, 2), (2, 1)
+    y[0][0], y[0][1], y[3][3] = (1, 1), (2, 33), (2, 1)
+    
+    fresh = search_engine.SearchEngine()
+    expected = fresh.find_best_move(y, 4, 1, 3)[:3]
+    
+    engine = search_engine.SearchEngine()
+    engine.set_verified(True, 1 << 12)
+    assert engine.is_verified()
+    engine.find_best_move(x, 4, 1, 3)
+    assert engine.find_best_move(y, 4, 1, 3)[:3] == expected
+    
+    # Boards above 6x6 fall back to the hashed table
+    board = GameBoard(8)
+    assert engine.find_best_move(board.to_engine_board(), 8, 1, 2)[:3] == \
+        fresh.find_best_move(board.to_engine_board(), 8, 1, 2)[:3]
+    
+    engine.set_verified(False)
+    assert not engine.is_verified()
+    
+    print("✓ Verified keys test passed")
+
+def test_cpp_mcts_rave():
+    """Test Monte Carlo tree search with RAVE statistics"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import search_engine
+    
+    board = GameBoard(8)
+    mcts = search_engine.MctsEngine(seed=1)
+    row, col, value, playouts = mcts.find_best_move(
+        board.to_engine_board(), 8, Player.A.value, 2000)
+    assert playouts == 2000
+    assert (row, col, value) in board.get_valid_moves(Player.A)
+    
+    # Root visits add up to the playouts, and AMAF counts every later claim
+    stats = mcts.get_root_stats()
+    assert sum(s[3] for s in stats) == playouts
+    assert all(s[5] >= s[3] for s in stats)
+    
+    # Same seed, same search
+    again = search_engine.MctsEngine(seed=1)
+    assert again.find_best_move(board.to_engine_board(), 8, Player.A.value, 2000) == \
+        (row, col, value, playouts)
+    
+    # Without RAVE (plain UCT) every root move is tried before any is repeated
+    wide = GameBoard(10)
+    for c in range(1, 9):
+        wide.set_cell(4, c, Player.A, c)
+        wide.set_cell(6, c, Player.B, c)
+    plain = search_engine.MctsEngine(rave_equivalence=0, seed=1)
+    plain.find_best_move(wide.to_engine_board(), 10, Player.A.value, 25)
+    assert [s[3] for s in plain.get_root_stats()] == [1] * 25
+    
+    # A tree too small for the root's children is rejected
+    try:
+        search_engine.MctsEngine(node_limit=2).find_best_move(GameBoard(6).to_engine_board(), 6,
+                                                               Player.A.value, 100)
+        assert False, "node_limit=2 accepted"
+    except ValueError:
+        pass
+    
+    print("✓ MCTS RAVE test passed")
+
+def test_cpp_mcts_solver():
+    """Test that MCTS proves small positions and stops early"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import search_engine
+    
+    # The first player wins 3x3 by taking the centre
+    board = GameBoard(3)
+    mcts = search_engine.MctsEngine(seed=1)
+    row, col, value, playouts = mcts.find_best_move(
+        board.to_engine_board(), 3, Player.A.value, 100000)
+    assert mcts.get_proven() == Player.A.value
+    assert playouts < 100000
+    assert (row, col) == (1, 1)
+    
+    # The winning move is marked proven in the root stats
+    stats = mcts.get_root_stats()
+    assert [s[7] for s in stats if (s[0], s[1]) == (1, 1)] == [Player.A.value]
+    
+    print("✓ MCTS solver test passed")
+
+def test_cpp_transposition_mcts():
+    """Test graph MCTS with a shared node table reused across searches"""
+    if not CPP_AVAILABLE:
+        return
+    
+    import search_engine
+    
+    board = GameBoard(7)
+    mcts = search_engine.TranspositionMcts(memory_mb=16, threads=2, seed=3)
+    row, col, value, playouts = mcts.find_best_move(
+        board.to_engine_board(), 7, Player.A.value, 3000)
+    assert playouts >= 3000
+    assert (row, col, value) in board.get_valid_moves(Player.A)
+    stats = mcts.get_table_stats()
+    assert 0 < stats["nodes"] <= stats["node_capacity"]
+    assert stats["memory_bytes"] <= 16 << 20
+    
+    # The next search of the same position starts from the stored root
+    visits = sum(s[3] for s in mcts.get_root_stats())
+    mcts.find_best_move(board.to_engine_board(), 7, Player.A.value, 1000)
+    assert mcts.get_table_stats()["reused_root_visits"] >= visits
+    
+    mcts.clear()
+    assert mcts.get_table_stats()["nodes"] == 0
+    
+    # Proofs work through the shared table too
+    small = GameBoard(3)
+    assert mcts.find_best_move(small.to_engine_board(), 3, Player.A.value, 100000)[:2] == (1, 1)
+    assert mcts.get_proven() == Player.A.value
+    
+    print("✓ Transposition MCTS test passed")
+
 def run_all_cpp_tests():
     """Run all C++ tests"""
     print("Running C++ Search Engine Tests...")
@@ -179,6 +1050,29 @@ def run_all_cpp_tests():
     test_cpp_performance()
     test_cpp_with_complex_position()
     test_cpp_transposition_table()
+    test_cpp_multiplayer()
+    test_cpp_tt_auto_size()
+    test_cpp_experience_book()
+    test_cpp_node_limit()
+    test_cpp_search_stats()
+    test_cpp_evaluate_batch()
+    test_cpp_lazy_eval()
+    test_cpp_mtdf()
+    test_cpp_numa_policy()
+    test_cpp_region_db()
+    test_cpp_scheduler()
+    test_cpp_ordering_tables()
+    test_cpp_vector_env()
+    test_cpp_request_replay()
+    test_cpp_sparse_engine()
+    test_cpp_search_params()
+    test_cpp_analysis_pipeline()
+    test_cpp_region_tracker()
+    test_cpp_dispatcher()
+    test_cpp_verified_keys()
+    test_cpp_mcts_rave()
+    test_cpp_mcts_solver()
+    test_cpp_transposition_mcts()
     
     print("=" * 50)
     print("All C++ tests passed! ✓")
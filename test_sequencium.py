@@ -3,7 +3,7 @@
 Simple tests for Sequencium game logic
 """
 
-from sequencium import GameBoard, Player, SequenciumAI
+from sequencium import GameBoard, NumpyGameBoard, Player, SequenciumAI, NUMPY_AVAILABLE
 
 
 def test_board_initialization():
@@ -113,6 +113,67 @@ def test_board_copy():
     print("✓ Board copy test passed")
 
 
+def test_multiplayer():
+    """Test 3- and 4-player boards and AI"""
+    board = GameBoard(6, num_players=4)
+    assert board.get_cell(0, 5) == (Player.C, 1)
+    assert board.get_cell(5, 0) == (Player.D, 1)
+    assert board.next_player(Player.D) == Player.A
+    
+    board3 = GameBoard(5, num_players=3)
+    assert board3.players == [Player.A, Player.B, Player.C]
+    assert board3.get_cell(4, 0) is None
+    
+    ai = SequenciumAI(max_depth=2, use_cpp=False)
+    move = ai.get_best_move(board3, Player.C)
+    assert move in board3.get_valid_moves(Player.C)
+    
+    print("✓ Multi-player test passed")
+
+
+def test_numpy_board():
+    """Test that the NumPy board plays the same game as GameBoard"""
+    if not NUMPY_AVAILABLE:
+        print("Skipping NumPy board test - numpy not installed")
+        return
+    
+    import random
+    
+    rng = random.Random(0)
+    for num_players in (2, 3):
+        board, fast = GameBoard(6, num_players), NumpyGameBoard(6, num_players)
+        player = Player.A
+        while not board.is_game_over():
+            assert not fast.is_game_over()
+            for p in board.players:
+                assert sorted(fast.get_valid_moves(p)) == sorted(board.get_valid_moves(p))
+                assert fast.get_max_value(p) == board.get_max_value(p)
+                assert fast.mobility(p) == board.mobility(p)
+                assert fast.cell_count(p) == board.cell_count(p)
+            moves = board.get_valid_moves(player)
+            if moves:
+                row, col, value = rng.choice(moves)
+                assert board.make_move(row, col, player, value)
+                assert fast.make_move(row, col, player, value)
+                # Occupied now, and never at a value other than the best one
+                assert not fast.make_move(row, col, player, value)
+            player = board.next_player(player)
+        assert fast.is_game_over()
+        assert fast.board == board.board and str(fast) == str(board)
+        assert fast.get_winner() == board.get_winner()
+    
+    board = NumpyGameBoard(6)
+    assert not board.make_move(1, 1, Player.A, 3)
+    board_copy = board.copy()
+    board_copy.make_move(1, 1, Player.A, 2)
+    assert board.get_cell(1, 1) is None and board_copy.get_cell(1, 1) == (Player.A, 2)
+    
+    ai = SequenciumAI(max_depth=2, use_cpp=False)
+    assert ai.get_best_move(board, Player.A) in board.get_valid_moves(Player.A)
+    
+    print("✓ NumPy board test passed")
+
+
 def run_all_tests():
     """Run all tests"""
     print("Running Sequencium Tests...")
@@ -125,6 +186,8 @@ def run_all_tests():
     test_winner_determination()
     test_ai_basic()
     test_board_copy()
+    test_multiplayer()
+    test_numpy_board()
     
     print("=" * 50)
     print("All tests passed! ✓")
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""
+Learn move-ordering tables from cutoff statistics
+
+Plays self-play games per board size with the C++ engine collecting which
+cell and value delta caused each cutoff (by game phase), then writes the
+tables that SequenciumAI loads at startup (ordering_tables.txt).
+
+Usage:
+    python3 train_ordering.py --sizes 6 8 10 --games 50 --depth 5
+"""
+
+import argparse
+import random
+import time
+from sequencium import GameBoard, Player, CPP_AVAILABLE, ORDERING_TABLES
+
+
+def self_play(engine, board_size, depth, rng, random_plies):
+    """Play one game, searching every position after the random opening"""
+    board = GameBoard(board_size)
+    player = Player.A
+    ply = 0
+    while not board.is_game_over():
+        valid_moves = board.get_valid_moves(player)
+        if valid_moves:
+            if ply < random_plies:
+                move = rng.choice(valid_moves)
+            else:
+                engine.clear_tt()
+                row, col, value, _ = engine.find_best_move(board.to_engine_board(), board_size,
+                                                           player.value, depth)
+                move = (row, col, value)
+            board.make_move(move[0], move[1], player, move[2])
+            ply += 1
+        player = board.next_player(player)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Learn move-ordering tables")
+    parser.add_argument("--sizes", type=int, nargs="+", default=[6, 8])
+    parser.add_argument("--games", type=int, default=30, help="games per board size")
+    parser.add_argument("--depth", type=int, default=5)
+    parser.add_argument("--random-plies", type=int, default=4)
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--output", default=ORDERING_TABLES)
+    args = parser.parse_args()
+    
+    if not CPP_AVAILABLE:
+        print("⚠ C++ engine not available!")
+        print("Run: python3 setup.py build_ext --inplace")
+        return
+    
+    import search_engine
+    
+    engine = search_engine.SearchEngine()
+    engine.collect_cutoff_stats(True)
+    rng = random.Random(args.seed)
+    
+    for board_size in args.sizes:
+        start = time.time()
+        for _ in range(args.games):
+            self_play(engine, board_size, args.depth, rng, args.random_plies)
+        print(f"{board_size}x{board_size}: {args.games} games in {time.time() - start:.1f}s")
+    
+    cutoff_nodes, first_move = engine.get_cutoff_stats()
+    if cutoff_nodes:
+        print(f"First-move cutoff rate while collecting: {100 * first_move / cutoff_nodes:.1f}%")
+    
+    engine.save_ordering_tables(args.output)
+    print(f"Wrote {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""
+Tune search parameters with SPSA self-play
+
+Each iteration perturbs every declared SearchEngine parameter by +/- its
+step (scaled by c_k), plays a native parallel self-play match between the
+two perturbed sets, and moves the parameters along the estimated gradient
+of the match score. The result is written as the parameter file that
+SequenciumAI loads at startup (search_params.txt).
+
+Usage:
+    python3 tune_spsa.py --iterations 200 --games 64 --depth 3 --nodes 2000
+"""
+
+import argparse
+import random
+import time
+from sequencium import CPP_AVAILABLE, SEARCH_PARAMS
+
+# Standard SPSA gain sequence exponents (Spall)
+ALPHA = 0.602
+GAMMA = 0.101
+
+
+def clamp(value, low, high):
+    return max(low, min(high, value))
+
+
+def rounded(theta, specs):
+    """Parameter dict the engine accepts (integers within range)"""
+    return {name: clamp(int(round(theta[name])), low, high)
+            for name, _, low, high, _ in specs}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="SPSA tuning of search parameters")
+    parser.add_argument("--iterations", type=int, default=100)
+    parser.add_argument("--games", type=int, default=64, help="games per iteration (even)")
+    parser.add_argument("--size", type=int, default=6)
+    parser.add_argument("--depth", type=int, default=3)
+    parser.add_argument("--nodes", type=int, default=0, help="node limit per move (0 = none)")
+    parser.add_argument("--random-plies", type=int, default=4)
+    parser.add_argument("--threads", type=int, default=0, help="0 = all cores")
+    parser.add_argument("--a", type=float, default=10.0,
+                        help="step size, in units of each parameter's step")
+    parser.add_argument("--c", type=float, default=1.0,
+                        help="perturbation size, in units of each parameter's step")
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--start", help="parameter file to start from (default: built-in)")
+    parser.add_argument("--output", default=SEARCH_PARAMS)
+    args = parser.parse_args()
+    
+    if not CPP_AVAILABLE:
+        print("⚠ C++ engine not available!")
+        print("Run: python3 setup.py build_ext --inplace")
+        return
+    
+    import search_engine
+    
+    specs = search_engine.tunable_params()
+    engine = search_engine.SearchEngine(tt_size=1024)
+    if args.start:
+        engine.load_params(args.start)
+    theta = {name: float(value) for name, value in engine.get_params().items()}
+    steps = {name: step for name, _, _, _, step in specs}
+    rng = random.Random(args.seed)
+    big_a = args.iterations / 10  # stability constant
+    
+    for k in range(args.iterations):
+        start = time.time()
+        a_k = args.a / (k + 1 + big_a) ** ALPHA
+        c_k = args.c / (k + 1) ** GAMMA
+        delta = {name: rng.choice((-1, 1)) for name in theta}
+        plus = rounded({n: theta[n] + c_k * steps[n] * delta[n] for n in theta}, specs)
+        minus = rounded({n: theta[n] - c_k * steps[n] * delta[n] for n in theta}, specs)
+        
+        wins, losses, draws = search_engine.play_match(
+            plus, minus, games=args.games, board_size=args.size, depth=args.depth,
+            nodes=args.nodes, random_plies=args.random_plies, threads=args.threads,
+            seed=args.seed * 1000003 + k)
+        score = (wins - losses) / max(1, wins + losses + draws)
+        
+        # theta += a_k * g_k, with g_k = score / (2 c_k delta) in step units
+        for name, _, low, high, _ in specs:
+            gradient = score / (2 * c_k * delta[name])
+            theta[name] = clamp(theta[name] + a_k * steps[name] * gradient, low, high)
+        
+        current = rounded(theta, specs)
+        print(f"iter {k + 1:4d}: +{wins} -{losses} ={draws} score {score:+.3f} "
+              f"({time.time() - start:.1f}s) " +
+              " ".join(f"{name}={value}" for name, value in current.items()))
+        engine.set_params(current)
+        engine.save_params(args.output)
+    
+    print(f"Wrote {args.output}")
+
+
+if __name__ == "__main__":
+    main()